@@ -1,4 +1,5 @@
 ﻿#include "App.h"
+#include "Parallel.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 #include <filesystem>
@@ -12,6 +13,14 @@
 
 static App* g_app = nullptr;
 
+namespace
+{
+    const float kSettleFrame = 1.0f / 60.0f;   // 정착 중 한 번에 진행하는 시뮬레이션 시간
+    const double kSettleSliceSec = 0.05;        // 이 벽시계 시간마다 한 번만 렌더
+    const int kSettleCalmFrames = 30;           // 이만큼 연속으로 임계값 아래면 정착 완료
+    const int kSettleMaxFrames = 60 * 120;      // 시뮬레이션 2분 안에 못 멈추면 포기
+}
+
 App::App(int width, int height)
     : winWidth(width), winHeight(height),
     cloth(20, 20, 0.2f),
@@ -81,37 +90,36 @@ bool App::init()
         auto& cloth = g_app->cloth;
         double mx = 0.0, my = 0.0;
         glfwGetCursorPos(win, &mx, &my);
-        glm::vec3 hit = g_app->screenToWorldOnPlane(mx, my, 0.0f);
-
-        const auto& P = cloth.getParticles();
-        int W = cloth.getWidth();
-        int H = cloth.getHeight();
-        if (W < 1 || H < 1) return;
-
-        // 코너 4개 인덱스 정의 (중복 코드 제거)
-        const int TL = 0;
-        const int TR = W - 1;
-        const int BL = (H - 1) * W;
-        const int BR = (H - 1) * W + (W - 1);
-        const int cornerIndices[4] = { TL, TR, BL, BR };
-
-        // 히트 반경 (spacing 근사: 가로/세로 중 존재하는 쪽 사용)
-        float spacingX = (W >= 2) ? glm::length(P[1].pos - P[0].pos) : 0.25f;
-        float spacingY = (H >= 2) ? glm::length(P[W].pos - P[0].pos) : spacingX;
-        float baseSpacing = (spacingX > 0.0f && spacingY > 0.0f) ? std::min(spacingX, spacingY) : spacingX;
+        ClothRayHit meshHit;
+        glm::vec3 hit;
+        bool onCloth = g_app->pickCloth(mx, my, hit, &meshHit);
+
+        if (cloth.getParticles().empty()) return;
+
+        // 코너 4개 인덱스 (그리드/메시 공통)
+        const auto& cornerIndices = cloth.getCornerIndices();
+
+        // 히트 반경 (spacing 기준, 메시 천은 평균 에지 길이)
+        float baseSpacing = (cloth.getSpacing() > 0.0f) ? cloth.getSpacing() : 0.25f;
         float r = baseSpacing * g_app->cornerHitScale;
 
         auto nearestCorner = [&](int& outIdx, float& outDist) {
             outIdx = -1; outDist = 1e9f;
             for (int i = 0; i < 4; i++) {
                 int idx = cornerIndices[i];
-                float d = glm::length(P[idx].pos - hit);
+                float d = glm::length(cloth.getParticlePos(idx) - hit);
                 if (d < outDist) { outDist = d; outIdx = idx; }
             }
             };
 
         if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
         {
+            // 드래그 평면: 집은 지점을 지나고 시선에 수직 (천 밖이면 기존처럼 z=0 평면)
+            glm::vec3 ro, rd;
+            g_app->screenRay(mx, my, ro, rd);
+            g_app->dragPlanePoint = hit;
+            g_app->dragPlaneNormal = onCloth ? rd : glm::vec3(0.0f, 0.0f, 1.0f);
+
             // 1) 코너 먼저 체크 -> 코너 안이면 Corner 드래그
             int cornerIdx; float cornerDist;
             nearestCorner(cornerIdx, cornerDist);
@@ -126,12 +134,8 @@ bool App::init()
                 return;
             }
 
-            // 2) 일반 파티클 드래그
-            int nearest = -1; float best = 1e9f;
-            for (int i = 0; i < (int)P.size(); i++) {
-                float d = glm::length(P[i].pos - hit);
-                if (d < best) { best = d; nearest = i; }
-            }
+            // 2) 일반 파티클 드래그 (적중 삼각형의 가장 가까운 정점, 천 밖이면 공간 색인 최근접)
+            int nearest = onCloth ? meshHit.nearestVertex : cloth.findNearestParticle(hit);
             g_app->dragMode = App::DragMode::Particle;
             g_app->dragAnchor = nearest;
             g_app->dragging = (nearest >= 0);
@@ -188,6 +192,7 @@ bool App::init()
     glGenVertexArrays(1, &flashVAO);
     glGenVertexArrays(1, &gizmoVAO);
     glGenBuffers(1, &gizmoVBO);
+    glGenQueries(2, renderQueries);
 
     glBindVertexArray(gizmoVAO);
     glBindBuffer(GL_ARRAY_BUFFER, gizmoVBO);
@@ -196,7 +201,14 @@ bool App::init()
     glEnableVertexAttribArray(0);
     glBindVertexArray(0);
 
-    cloth.buildIndices(cloth.getWidth(), cloth.getHeight());
+    // 격자 인덱스는 생성자에서 이미 만들어짐
+    if (cloth.isGrid())
+    {
+        const auto& topo = cloth.getTopologyBuildStats();
+        std::cout << "Cloth topology: " << cloth.getParticles().size() << " particles, "
+            << cloth.getSprings().size() << " springs in " << topo.totalMs() << " ms (particles "
+            << topo.particlesMs << ", springs " << topo.springsMs << ", indices " << topo.indicesMs << ")\n";
+    }
     cloth.initGL();
 
     clothTex = loadTexture2D(currentTexPath.c_str(), true);
@@ -222,27 +234,40 @@ void App::run()
         processInput(dt);
 
         // 드래그 (freeze 중에는 차단)
-        if (freezeTimer <= 0.0f && dragging)
+        if (freezeTimer <= 0.0f && dragging && !settling)
         {
             double mx, my; glfwGetCursorPos(window, &mx, &my);
-            glm::vec3 p = screenToWorldOnPlane(mx, my, 0.0f);
+            glm::vec3 p = screenToClothPlane(mx, my, dragPlanePoint, dragPlaneNormal);
 
             if (dragMode == DragMode::Corner && dragCorner >= 0)
             {
                 cloth.setParticlePos(dragCorner, p, true);
+                cloth.markInteraction(dragCorner);
             }
             else if (dragMode == DragMode::Particle && dragAnchor >= 0 && !cloth.isParticleFixed(dragAnchor))
             {
                 cloth.setParticlePos(dragAnchor, p, true);
+                cloth.markInteraction(dragAnchor);
             }
         }
 
         // 물리 업데이트 (freeze 중에는 스킵)
-        if (freezeTimer <= 0.0f)
+        const double simStart = glfwGetTime();
+        if (settling)
+        {
+            stepSettle();
+        }
+        else if (freezeTimer <= 0.0f)
         {
-            cloth.update(dt);
+            if (layerCloth) clothCollision.advance(dt);
+            else cloth.advance(dt);
         }
+        const double uploadStart = glfwGetTime();
         cloth.updateGPU();
+        if (layerCloth) layerCloth->updateGPU();
+        const double renderStart = glfwGetTime();
+        GLuint renderQuery = renderQueries[renderQueryFrames & 1];
+        glBeginQuery(GL_TIME_ELAPSED, renderQuery);
 
         // 플래시 감쇠
         flash = std::max(0.0f, flash - dt * 6.0f);
@@ -254,7 +279,7 @@ void App::run()
         // 행렬 계산 (중복 코드 제거)
         glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)winWidth / (float)winHeight, 0.1f, 100.0f);
         glm::mat4 view = camera.GetViewMatrix();
-        glm::mat4 model = glm::rotate(glm::mat4(1.0f), modelAngle, glm::vec3(0, 1, 0));
+        glm::mat4 model = modelMatrix();
 
         // 천 렌더링
         clothShader->use();
@@ -280,21 +305,15 @@ void App::run()
         clothShader->setFloat("uSpecularStrength", 0.25f);
         clothShader->setFloat("uShininess", 48.0f);
         cloth.drawTriangles();
+        if (layerCloth) layerCloth->drawTriangles();
 
         // --- 코너 표시 Gizmo ---
-        const auto& P = cloth.getParticles();
-        int W = cloth.getWidth();
-        int H = cloth.getHeight();
-
         // 코너 인덱스 재사용
-        const int TL = 0;
-        const int TR = W - 1;
-        const int BL = (H - 1) * W;
-        const int BR = (H - 1) * W + (W - 1);
-        int cornerIdx[4] = { TL, TR, BL, BR };
+        const auto& cornerIdx = cloth.getCornerIndices();
 
         // 코너 위치 업데이트
-        glm::vec3 corners[4] = { P[TL].pos, P[TR].pos, P[BL].pos, P[BR].pos };
+        glm::vec3 corners[4] = { cloth.getParticlePos(cornerIdx[0]), cloth.getParticlePos(cornerIdx[1]),
+            cloth.getParticlePos(cornerIdx[2]), cloth.getParticlePos(cornerIdx[3]) };
         glBindBuffer(GL_ARRAY_BUFFER, gizmoVBO);
         glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(corners), corners);
 
@@ -422,6 +441,9 @@ void App::run()
             }
 
             ImGui::End();
+
+            drawSimulationPanel();
+            if (settling) drawSettleProgress();
         }
 
 
@@ -429,6 +451,27 @@ void App::run()
         glDisable(GL_DEPTH_TEST);
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
         glEnable(GL_DEPTH_TEST);
+        glEndQuery(GL_TIME_ELAPSED);
+
+        // 프레임 예산: 스왑(수직 동기 대기)은 빼고, 렌더는 CPU 제출 시간과 직전 프레임 GPU 시간 중 큰 쪽
+        lastFrameTiming.simMs = static_cast<float>((uploadStart - simStart) * 1000.0);
+        lastFrameTiming.uploadMs = static_cast<float>((renderStart - uploadStart) * 1000.0);
+        lastFrameTiming.renderMs = static_cast<float>((glfwGetTime() - renderStart) * 1000.0);
+        if (renderQueryFrames > 0)
+        {
+            GLuint prevQuery = renderQueries[(renderQueryFrames - 1) & 1];
+            GLint available = 0;
+            glGetQueryObjectiv(prevQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available)
+            {
+                GLuint64 gpuNs = 0;
+                glGetQueryObjectui64v(prevQuery, GL_QUERY_RESULT, &gpuNs);
+                lastFrameTiming.renderMs = std::max(lastFrameTiming.renderMs, static_cast<float>(gpuNs * 1e-6));
+            }
+        }
+        renderQueryFrames++;
+        if (frameBudgetEnabled && freezeTimer <= 0.0f && !settling && frameBudget.update(lastFrameTiming))
+            applyQualityLevel();
 
         glfwSwapBuffers(window);
         glfwPollEvents();
@@ -443,12 +486,24 @@ void App::run()
     if (flashVAO) glDeleteVertexArrays(1, &flashVAO);
     if (gizmoVBO) glDeleteBuffers(1, &gizmoVBO);
     if (gizmoVAO) glDeleteVertexArrays(1, &gizmoVAO);
+    if (renderQueries[0]) glDeleteQueries(2, renderQueries);
     delete gizmoShader;
     delete flashShader;
     delete clothShader;
     glfwTerminate();
 }
 
+bool App::loadClothMesh(const std::string& path)
+{
+    if (!cloth.loadFromOBJ(path)) return false;
+
+    dragging = false;
+    dragAnchor = -1;
+    dragCorner = -1;
+    dragMode = DragMode::None;
+    return true;
+}
+
 void App::generateAndLoadTextureFromPrompt(const std::string& prompt,
     const std::string& negative)
 {
@@ -510,6 +565,367 @@ void App::generateAndLoadTextureFromPrompt(const std::string& prompt,
 }
 
 
+// 앞쪽에 작은 천을 한 장 더 걸어 천 사이 충돌을 켬 (바람/난류 설정은 본 천을 따름)
+void App::setLayerCloth(bool enabled)
+{
+    clothCollision.clear();
+    if (!enabled)
+    {
+        layerCloth.reset();
+        return;
+    }
+
+    layerCloth = std::make_unique<SceneCloth>(16, 16, 0.2f);
+    layerCloth->translate(glm::vec3(0.0f, 0.3f, 0.3f));
+    layerCloth->setWind(cloth.getWind());
+    layerCloth->setWindField(turbulenceEnabled ? &windField : nullptr);
+    layerCloth->initGL();
+    applyFloorCollider();
+    applyQualityLevel();
+
+    clothCollision.addCloth(&cloth);
+    clothCollision.addCloth(layerCloth.get());
+}
+
+// 현재 모양 그대로 격자 해상도만 바꿈 (드래그 중인 정점 번호는 무효가 되므로 드래그 해제)
+void App::resampleCloth(int width)
+{
+    const int w = cloth.getWidth(), h = cloth.getHeight();
+    const int height = std::max(2, static_cast<int>(std::lround((h - 1) * (width - 1) / static_cast<double>(w - 1))) + 1);
+    if (!cloth.resampleGrid(width, height)) return;
+
+    dragging = false;
+    dragAnchor = -1;
+    dragMode = DragMode::None;
+    dragCorner = -1;
+    std::cout << "Resampled cloth to " << width << "x" << height << "\n";
+}
+
+// 바닥 평면을 다시 설정 (충돌체가 바뀌면 천의 접촉 캐시도 비워짐)
+void App::applyFloorCollider()
+{
+    const Collider floor = Collider::plane(glm::vec3(0.0f, floorHeight, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    cloth.clearColliders();
+    if (floorEnabled) cloth.addCollider(floor);
+    if (layerCloth)
+    {
+        layerCloth->clearColliders();
+        if (floorEnabled) layerCloth->addCollider(floor);
+    }
+}
+
+// 프레임 예산 단계를 천(겹친 천 포함)에 적용 (예산을 끄면 패널 설정 그대로)
+void App::applyQualityLevel()
+{
+    const FrameBudget::Level& level = frameBudget.getLevel();
+    auto apply = [&](SceneCloth& c) {
+        TimeStepParams ts = c.getTimeStep();
+        ts.maxSubsteps = frameBudgetEnabled ? std::min(maxSubstepsSetting, level.maxSubsteps) : maxSubstepsSetting;
+        c.setTimeStep(ts);
+        c.setIterationCap(frameBudgetEnabled ? level.iterationCap : 0);
+        c.setNormalInterval(frameBudgetEnabled ? level.normalInterval : 1);
+    };
+    apply(cloth);
+    if (layerCloth) apply(*layerCloth);
+}
+
+void App::startSettle()
+{
+    dragging = false;
+    dragMode = DragMode::None;
+    settling = true;
+    settleFrames = settleCalmFrames = 0;
+    settleEnergy = settlePeakEnergy = settlePrevEnergy = 0.0f;
+    settleProgress = 0.0f;
+    settleStartTime = glfwGetTime();
+
+    // 접촉이 있으면 멈추는 경로에 따라 걸리는 모양이 달라지므로 운동 감쇠는 충돌체가 없을 때만
+    settleKinetic = !layerCloth && cloth.getColliders().empty();
+    settlePolishing = ThreadPool::instance().size() <= 1;
+    setSettleParallel(!settlePolishing);
+}
+
+void App::cancelSettle()
+{
+    if (settling) finishSettle(false);
+}
+
+void App::finishSettle(bool converged)
+{
+    settling = false;
+    setSettleParallel(false);
+    settleLastMs = (glfwGetTime() - settleStartTime) * 1000.0;
+    settleLastFrames = settleFrames;
+    settleLastConverged = converged;
+}
+
+void App::setSettleParallel(bool enabled)
+{
+    cloth.setParallelSolve(enabled);
+    if (layerCloth) layerCloth->setParallelSolve(enabled);
+}
+
+// 한 조각 (kSettleSliceSec) 동안 고정 프레임으로 계속 진행
+// 운동 감쇠: 에너지가 직전 프레임보다 줄면 진동의 꼭대기를 지난 것이므로 속도를 버림
+void App::stepSettle()
+{
+    const double sliceEnd = glfwGetTime() + kSettleSliceSec;
+    do
+    {
+        if (layerCloth) clothCollision.advance(kSettleFrame);
+        else cloth.advance(kSettleFrame);
+        settleFrames++;
+
+        settleEnergy = cloth.getKineticEnergy();
+        if (layerCloth) settleEnergy = std::max(settleEnergy, layerCloth->getKineticEnergy());
+        settlePeakEnergy = std::max(settlePeakEnergy, settleEnergy);
+        settleCalmFrames = (settleEnergy < settleThreshold) ? settleCalmFrames + 1 : 0;
+        if (settleKinetic && settleEnergy < settlePrevEnergy)
+        {
+            cloth.scaleVelocities(0.0f);
+            settlePrevEnergy = 0.0f;
+        }
+        else
+        {
+            settlePrevEnergy = settleEnergy;
+        }
+
+        // 병렬 순회는 순서가 달라 남는 늘어남이 조금 다르므로, 멈추면 직렬 순회로 한 번 더 멈출 때까지 진행
+        if (settleCalmFrames >= kSettleCalmFrames && !settlePolishing)
+        {
+            settlePolishing = true;
+            setSettleParallel(false);
+            settleCalmFrames = 0;
+        }
+        const bool converged = settleCalmFrames >= kSettleCalmFrames;
+        if (converged || settleFrames >= kSettleMaxFrames)
+        {
+            finishSettle(converged);
+            return;
+        }
+    } while (glfwGetTime() < sliceEnd);
+
+    // 진행률: 최고 에너지에서 임계값까지 로그 거리 (90%) + 연속 조용한 프레임 (10%), 뒤로 가지 않음
+    float decay = 1.0f;
+    if (settlePeakEnergy > settleThreshold)
+    {
+        const float e = std::max(settleEnergy, settleThreshold);
+        decay = std::log(settlePeakEnergy / e) / std::log(settlePeakEnergy / settleThreshold);
+    }
+    const float p = 0.9f * std::clamp(decay, 0.0f, 1.0f) + 0.1f * settleCalmFrames / kSettleCalmFrames;
+    settleProgress = std::max(settleProgress, p);
+}
+
+// 화면 가운데 진행 막대 + 취소 (ESC로도 취소)
+void App::drawSettleProgress()
+{
+    ImGuiIO& io = ImGui::GetIO();
+    ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+    ImGui::SetNextWindowSize(ImVec2(320.0f, 0.0f));
+    ImGui::Begin("Settling", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove
+        | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoSavedSettings);
+    ImGui::ProgressBar(settleProgress, ImVec2(-1.0f, 0.0f));
+    ImGui::Text("%d frames (%.1f s)  energy %.2e", settleFrames, settleFrames * kSettleFrame, settleEnergy);
+    ImGui::Text("%s, %d threads%s", settlePolishing ? "serial polish" : "parallel sweep",
+        settlePolishing ? 1 : ThreadPool::instance().size(), settleKinetic ? ", kinetic damping" : "");
+    if (ImGui::Button("Cancel")) cancelSettle();
+    ImGui::End();
+}
+
+void App::drawSimulationPanel()
+{
+    ImGui::Begin("Simulation");
+
+    // ---------- Solver ----------
+    float tol = cloth.getSolverTolerance();
+    if (ImGui::SliderFloat("Residual tolerance", &tol, 0.0f, 0.05f, "%.4f")) {
+        cloth.setSolverTolerance(tol);
+    }
+    const auto& solve = cloth.getLastSolveStats();
+    ImGui::Text("Iterations: %d  strain max %.4f / rms %.4f",
+        cloth.getLastIterationCount(), solve.maxStrain, solve.rmsStrain);
+
+    TimeStepParams ts = cloth.getTimeStep();
+    bool tsChanged = false;
+    tsChanged |= ImGui::SliderFloat("CFL", &ts.cflNumber, 0.05f, 2.0f, "%.2f");
+    tsChanged |= ImGui::SliderInt("Max substeps", &maxSubstepsSetting, 1, 32);
+    if (tsChanged) {
+        cloth.setTimeStep(ts);
+        applyQualityLevel();
+    }
+    ImGui::Text("Substeps: %d  dt %.2f ms", cloth.getLastSubsteps(), cloth.getLastStepSize() * 1000.0f);
+
+    // 프레임 예산: 넘으면 서브스텝 -> 반복 수 -> 노멀 갱신 순으로 품질을 낮춤
+    if (ImGui::Checkbox("Frame budget", &frameBudgetEnabled)) {
+        frameBudget.reset();
+        applyQualityLevel();
+    }
+    float budgetMs = frameBudget.getTargetMs();
+    if (ImGui::SliderFloat("Budget ms", &budgetMs, 4.0f, 50.0f, "%.1f")) frameBudget.setTargetMs(budgetMs);
+    ImGui::Text("Frame: sim %.2f  upload %.2f  render %.2f ms",
+        lastFrameTiming.simMs, lastFrameTiming.uploadMs, lastFrameTiming.renderMs);
+    if (frameBudgetEnabled) {
+        const FrameBudget::Level& level = frameBudget.getLevel();
+        ImGui::Text("Quality %d/%d: substeps %d, iterations %d, normals every %d",
+            frameBudget.getLevelIndex(), FrameBudget::getLevelCount() - 1, cloth.getTimeStep().maxSubsteps,
+            level.iterationCap > 0 ? level.iterationCap : Cloth::kMaxConstraintIters, level.normalInterval);
+
+        // 패널을 접어도 보이도록 화면 왼쪽 위에 현재 단계 표시
+        char hud[96];
+        snprintf(hud, sizeof(hud), "Quality %d/%d  %.1f / %.1f ms", frameBudget.getLevelIndex(),
+            FrameBudget::getLevelCount() - 1, frameBudget.getSmoothed().total(), frameBudget.getTargetMs());
+        ImGui::GetForegroundDrawList()->AddText(ImVec2(8.0f, 8.0f), IM_COL32(255, 255, 255, 220), hud);
+    }
+
+    // 빠른 정착 (Shift+S와 같음)
+    ImGui::SliderFloat("Settle energy", &settleThreshold, 1e-8f, 1e-3f, "%.1e",
+        ImGuiSliderFlags_Logarithmic | ImGuiSliderFlags_NoRoundToFormat);
+    if (ImGui::Button(settling ? "Cancel settle" : "Settle")) {
+        if (settling) cancelSettle();
+        else startSettle();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Reset + settle")) {
+        cloth.resetToRest();
+        if (layerCloth) layerCloth->resetToRest();
+        startSettle();
+    }
+    if (settleLastMs >= 0.0) {
+        ImGui::Text("Last settle: %.0f ms, %d frames (%.1f s)%s", settleLastMs, settleLastFrames,
+            settleLastFrames * kSettleFrame, settleLastConverged ? "" : "  (stopped)");
+    }
+
+    // 변형률 제한 (끄면 종류별 e를 0으로)
+    static const char* kSpringTypeNames[] = { "Limit structural", "Limit shear", "Limit bend" };
+    bool limitChanged = ImGui::Checkbox("Strain limiting", &strainLimitEnabled);
+    for (int t = 0; t < 3; t++) {
+        limitChanged |= ImGui::SliderFloat(kSpringTypeNames[t], &strainLimitSetting[t], 0.0f, 0.5f, "%.3f");
+    }
+    if (limitChanged) {
+        for (int t = 0; t < 3; t++)
+            cloth.setStrainLimit(static_cast<SpringType>(t), strainLimitEnabled ? strainLimitSetting[t] : 0.0f);
+    }
+
+    // 종류별 일정: 스텝당 반복 상한 (0이면 적응 반복 전체)과 갱신 간격 (서브스텝)
+    static const char* kIterNames[] = { "Iters structural", "Iters shear", "Iters bend" };
+    static const char* kIntervalNames[] = { "Every structural", "Every shear", "Every bend" };
+    for (int t = 0; t < 3; t++) {
+        Cloth::SpringSchedule sc = cloth.getSpringSchedule(static_cast<SpringType>(t));
+        bool scheduleChanged = ImGui::SliderInt(kIterNames[t], &sc.iterations, 0, Cloth::kMaxConstraintIters);
+        scheduleChanged |= ImGui::SliderInt(kIntervalNames[t], &sc.interval, 1, 4);
+        if (scheduleChanged) cloth.setSpringSchedule(static_cast<SpringType>(t), sc);
+    }
+    ImGui::Text("Spring visits/step: %lld", cloth.getLastSpringVisits());
+
+    // 드래그/충격/핀 변경 지점 주변 국소 반복
+    LocalSolveParams local = cloth.getLocalSolve();
+    bool localChanged = ImGui::SliderInt("Local iterations", &local.iterations, 0, 16);
+    localChanged |= ImGui::SliderInt("Local hops", &local.hops, 1, 16);
+    localChanged |= ImGui::SliderInt("Local hold steps", &local.holdSteps, 1, 60);
+    if (localChanged) cloth.setLocalSolve(local);
+    ImGui::Text("Local springs: %d", cloth.getLastLocalSprings());
+
+    // 통합/첫 순회, 마지막 순회/노멀을 행 블록 단위로 묶는 고정 반복 경로 (격자 천)
+    bool fusedOn = cloth.isFusedPipeline();
+    int fusedIters = cloth.getFusedIterations();
+    bool fusedChanged = ImGui::Checkbox("Fused pipeline", &fusedOn);
+    fusedChanged |= ImGui::SliderInt("Fused iterations", &fusedIters, 1, Cloth::kMaxConstraintIters);
+    if (fusedChanged) cloth.setFusedPipeline(fusedOn, fusedIters);
+    if (fusedOn && !cloth.isFusedPipelineActive()) ImGui::TextDisabled("(not a pristine grid: using the regular path)");
+
+    // ---------- Tearing ----------
+    ImGui::Separator();
+    bool tearing = cloth.getTearStrain() > 0.0f;
+    if (ImGui::Checkbox("Tearing", &tearing)) {
+        cloth.setTearStrain(tearing ? tearStrainSetting : 0.0f);
+    }
+    if (ImGui::SliderFloat("Tear strain", &tearStrainSetting, 0.05f, 2.0f, "%.2f") && tearing) {
+        cloth.setTearStrain(tearStrainSetting);
+    }
+    ImGui::Text("Torn vertices: %d", cloth.getTornVertexCount());
+
+    // ---------- Resolution ----------
+    if (cloth.isGrid()) {
+        ImGui::Separator();
+        ImGui::SliderInt("Grid width", &gridWidthSetting, 4, 400);
+        ImGui::SameLine();
+        if (ImGui::Button("Resample")) resampleCloth(gridWidthSetting);
+        ImGui::Text("Grid %dx%d  spacing %.4f", cloth.getWidth(), cloth.getHeight(), cloth.getSpacing());
+    }
+
+    // ---------- Floor ----------
+    ImGui::Separator();
+    bool floorChanged = ImGui::Checkbox("Floor collider", &floorEnabled);
+    floorChanged |= ImGui::SliderFloat("Floor height", &floorHeight, -3.0f, 1.0f, "%.2f");
+    if (floorChanged) applyFloorCollider();
+    if (floorEnabled) {
+        const auto& cs = cloth.getLastContactStats();
+        ImGui::Text("Floor contacts %d  requeried %d / %d", cs.contacts, cs.requeried, static_cast<int>(cloth.getParticles().size()));
+    }
+
+    // ---------- Layered cloth ----------
+    ImGui::Separator();
+    bool layered = layerCloth != nullptr;
+    if (ImGui::Checkbox("Layered cloth", &layered)) {
+        setLayerCloth(layered);
+    }
+    if (layerCloth) {
+        float thickness = clothCollision.getThickness();
+        if (ImGui::SliderFloat("Contact thickness", &thickness, 0.005f, 0.2f, "%.3f")) {
+            clothCollision.setThickness(thickness);
+        }
+        const auto& cs = clothCollision.getLastStats();
+        ImGui::Text("Tiles %d  pairs %d  contacts %d", cs.tiles, cs.candidatePairs, cs.contacts);
+    }
+
+    // ---------- Wind ----------
+    ImGui::Separator();
+    WindParams wind = cloth.getWind();
+    bool windChanged = false;
+    windChanged |= ImGui::DragFloat3("Wind velocity", &wind.velocity.x, 0.05f, -30.0f, 30.0f, "%.2f");
+    windChanged |= ImGui::SliderFloat("Drag Cd", &wind.dragCoeff, 0.0f, 3.0f, "%.2f");
+    windChanged |= ImGui::SliderFloat("Lift Cl", &wind.liftCoeff, 0.0f, 3.0f, "%.2f");
+    windChanged |= ImGui::SliderFloat("Air density", &wind.airDensity, 0.0f, 5.0f, "%.2f");
+    windChanged |= ImGui::SliderFloat("Cloth kg/m^2", &wind.arealDensity, 0.01f, 1.0f, "%.3f");
+    if (windChanged) {
+        cloth.setWind(wind);
+        if (layerCloth) layerCloth->setWind(wind);
+    }
+
+    if (ImGui::Checkbox("Turbulence", &turbulenceEnabled)) {
+        cloth.setWindField(turbulenceEnabled ? &windField : nullptr);
+        if (layerCloth) layerCloth->setWindField(turbulenceEnabled ? &windField : nullptr);
+    }
+    WindField::Params field = windField.getParams();
+    bool fieldChanged = false;
+    fieldChanged |= ImGui::SliderFloat("Gust RMS", &field.amplitude, 0.0f, 10.0f, "%.2f");
+    fieldChanged |= ImGui::SliderFloat("Gust size", &field.tileSize, 0.5f, 16.0f, "%.1f");
+    fieldChanged |= ImGui::SliderFloat("Gust speed", &field.timeScale, 0.0f, 4.0f, "%.2f");
+    if (fieldChanged) windField.setParams(field);
+
+    // ---------- Memory ----------
+    ImGui::Separator();
+    placementAge += ImGui::GetIO().DeltaTime;
+    if (placementAge >= 1.0f) {
+        bufferPlacement = cloth.queryBufferPlacement();
+        placementAge = 0.0f;
+    }
+    for (const auto& b : bufferPlacement) {
+        const PagePlacement& pl = b.placement;
+        char nodes[96] = "";
+        int len = 0;
+        for (int n = 0; n < kMaxPageNodes && pl.sampledPages > 0; n++) {
+            if (pl.nodePages[n] == 0) continue;
+            len += std::snprintf(nodes + len, sizeof(nodes) - len, " n%d %d%%", n, pl.nodePages[n] * 100 / pl.sampledPages);
+            if (len >= static_cast<int>(sizeof(nodes))) break;
+        }
+        ImGui::Text("%-9s %7.1f MB  huge %5.1f MB%s%s", b.name, pl.bytes / 1048576.0, pl.hugeBytes / 1048576.0,
+            pl.pageBacked ? "" : "  (heap)", nodes);
+    }
+
+    ImGui::End();
+}
+
 void App::processInput(float dt)
 {
     ImGuiIO& io = ImGui::GetIO();
@@ -523,11 +939,12 @@ void App::processInput(float dt)
 
     if (clicked && freezeTimer <= 0.0f && !dragging) {
         double mx, my; glfwGetCursorPos(window, &mx, &my);
-        glm::vec3 hit = screenToWorldOnPlane(mx, my, 0.0f);
+        glm::vec3 hit;
+        pickCloth(mx, my, hit);
 
-        // 카메라 -> 히트 방향
-        glm::vec3 camPos = glm::vec3(glm::inverse(camera.GetViewMatrix())[3]);
-        glm::vec3 dir = glm::normalize(hit - camPos);
+        // 카메라 -> 히트 방향 (천 로컬 공간)
+        glm::vec3 ro, dir;
+        screenRay(mx, my, ro, dir);
 
         // 튜닝 파라미터
         float impulseStrength = 0.6f;
@@ -539,13 +956,18 @@ void App::processInput(float dt)
     static int prevEsc = GLFW_RELEASE;
     int escKey = glfwGetKey(window, GLFW_KEY_ESCAPE);
     if (escKey == GLFW_PRESS && prevEsc == GLFW_RELEASE) {
-        glfwSetWindowShouldClose(window, true);
+        // 정착 중이면 정착만 취소
+        if (settling) cancelSettle();
+        else glfwSetWindowShouldClose(window, true);
     }
     prevEsc = escKey;
 
+    bool shift = (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) ||
+        (glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS);
+
     // ----- 이동/컨트롤 키 -----
     if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) camera.ProcessKeyboard(FORWARD, dt);
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) camera.ProcessKeyboard(BACKWARD, dt);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS && !shift) camera.ProcessKeyboard(BACKWARD, dt);
     if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) camera.ProcessKeyboard(LEFT, dt);
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) camera.ProcessKeyboard(RIGHT, dt);
 
@@ -565,10 +987,21 @@ void App::processInput(float dt)
     if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) modelAngle += rotSpeed * dt;
 
     if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
+        cancelSettle();
         cloth.resetToRest();
+        if (layerCloth) layerCloth->resetToRest();
         modelAngle = 0.0f;
     }
 
+    // ----- Shift+S: 빠른 정착 시작 / 취소 -----
+    static int pS = GLFW_RELEASE;
+    int cS = glfwGetKey(window, GLFW_KEY_S);
+    if (cS == GLFW_PRESS && pS == GLFW_RELEASE && shift) {
+        if (settling) cancelSettle();
+        else startSettle();
+    }
+    pS = cS;
+
     // ----- O: Export + 플래시 + 프리뷰(일시정지) -----
     static int pO = GLFW_RELEASE;
     int cO = glfwGetKey(window, GLFW_KEY_O);
@@ -591,8 +1024,6 @@ void App::processInput(float dt)
     // ----- G / Shift+G: 재생성 / 파일만 리로드 -----
     static int pG = GLFW_RELEASE;
     int  cG = glfwGetKey(window, GLFW_KEY_G);
-    bool shift = (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) ||
-        (glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS);
 
     if (cG == GLFW_PRESS && pG == GLFW_RELEASE) {
         if (shift) {
@@ -611,29 +1042,57 @@ void App::processInput(float dt)
 }
 
 
-glm::vec3 App::screenToWorldOnPlane(double sx, double sy, float planeZ)
+glm::mat4 App::modelMatrix() const
+{
+    return glm::rotate(glm::mat4(1.0f), modelAngle, glm::vec3(0, 1, 0));
+}
+
+void App::screenRay(double sx, double sy, glm::vec3& origin, glm::vec3& dir)
 {
     glm::mat4 proj = glm::perspective(glm::radians(45.0f), (float)winWidth / winHeight, 0.1f, 100.0f);
     glm::mat4 view = camera.GetViewMatrix();
-    glm::mat4 invVP = glm::inverse(proj * view);
+    glm::mat4 invMVP = glm::inverse(proj * view * modelMatrix());
 
     float x = (float)((sx / winWidth) * 2.0 - 1.0);
     float y = (float)(1.0 - (sy / winHeight) * 2.0);
 
-    glm::vec4 p0 = invVP * glm::vec4(x, y, 0.0, 1.0);
-    glm::vec4 p1 = invVP * glm::vec4(x, y, 1.0, 1.0);
+    glm::vec4 p0 = invMVP * glm::vec4(x, y, 0.0, 1.0);
+    glm::vec4 p1 = invMVP * glm::vec4(x, y, 1.0, 1.0);
     p0 /= p0.w; p1 /= p1.w;
 
-    glm::vec3 ro = glm::vec3(p0);
-    glm::vec3 rd = glm::normalize(glm::vec3(p1 - p0));
+    origin = glm::vec3(p0);
+    dir = glm::normalize(glm::vec3(p1 - p0));
+}
+
+glm::vec3 App::screenToClothPlane(double sx, double sy, const glm::vec3& planePoint, const glm::vec3& planeNormal)
+{
+    glm::vec3 ro, rd;
+    screenRay(sx, sy, ro, rd);
 
-    float denom = rd.z;
+    float denom = glm::dot(rd, planeNormal);
     if (fabsf(denom) < 1e-6f) return ro;
 
-    float t = (planeZ - ro.z) / denom;
+    float t = glm::dot(planePoint - ro, planeNormal) / denom;
     return ro + rd * t;
 }
 
+bool App::pickCloth(double sx, double sy, glm::vec3& hit, ClothRayHit* meshHit)
+{
+    glm::vec3 ro, rd;
+    screenRay(sx, sy, ro, rd);
+
+    ClothRayHit h;
+    if (cloth.raycast(ro, rd, h))
+    {
+        hit = h.point;
+        if (meshHit) *meshHit = h;
+        return true;
+    }
+
+    hit = screenToClothPlane(sx, sy, glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    return false;
+}
+
 void App::reloadTexture(const std::string& path)
 {
     if (!std::filesystem::exists(path)) {
@@ -4,13 +4,31 @@
 #include <GLFW/glfw3.h>
 
 #include "Cloth.h"
+#include "ClothCollision.h"
 #include "Camera.h"
+#include "FrameBudget.h"
 #include "Shader.h"
+#include "WindField.h"
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 
+#include <memory>
+
+// 장면 천 정밀도: CLOTH_PRECISION 0 = float, 1 = double, 2 = double 위치 + float 제약
+// (--bench-precision으로 장면별 속도/오차를 비교한 뒤 빌드 설정에서 선택)
+#ifndef CLOTH_PRECISION
+#define CLOTH_PRECISION 0
+#endif
+#if CLOTH_PRECISION == 1
+using SceneCloth = ClothDouble;
+#elif CLOTH_PRECISION == 2
+using SceneCloth = ClothMixed;
+#else
+using SceneCloth = Cloth;
+#endif
+
 class App
 {
 public:
@@ -18,6 +36,9 @@ public:
     bool init();
     void run();
 
+    // OBJ 패널로 천 교체 (init 전/후 모두 가능)
+    bool loadClothMesh(const std::string& path);
+
 private:
     unsigned int loadTexture2D(const char* path, bool srgb);
 
@@ -27,7 +48,7 @@ private:
     int winHeight;
 
     // 시뮬레이션
-    Cloth  cloth;
+    SceneCloth cloth;
     Camera camera;
     Shader* clothShader = nullptr;
 
@@ -39,12 +60,20 @@ private:
     DragMode dragMode = DragMode::None;
     int      dragCorner = -1;
     float    cornerHitScale = 2.0f;
+    glm::vec3 dragPlanePoint = glm::vec3(0.0f);  // 드래그 평면 (천 로컬 공간, 시선에 수직)
+    glm::vec3 dragPlaneNormal = glm::vec3(0.0f, 0.0f, 1.0f);
 
     // 내부 동작
     void generateAndLoadTextureFromPrompt(const std::string& prompt,
         const std::string& negative);
     void processInput(float dt);
-    glm::vec3 screenToWorldOnPlane(double sx, double sy, float planeZ);
+    glm::mat4 modelMatrix() const;
+    // 화면 좌표 -> 천 로컬 공간 광선 (modelAngle 회전까지 되돌림)
+    void screenRay(double sx, double sy, glm::vec3& origin, glm::vec3& dir);
+    // 천 로컬 공간 평면과 마우스 광선의 교점
+    glm::vec3 screenToClothPlane(double sx, double sy, const glm::vec3& planePoint, const glm::vec3& planeNormal);
+    // 마우스 아래 천 표면 (천을 벗어나면 z=0 평면으로 대체, 반환값은 메시 적중 여부)
+    bool pickCloth(double sx, double sy, glm::vec3& hit, ClothRayHit* meshHit = nullptr);
 
     // 렌더/머터리얼
     unsigned int clothTex = 0;
@@ -79,5 +108,66 @@ private:
 
     bool rightDownPrev = false;
 
+    // 시뮬레이션 패널 (ImGui)
+    void drawSimulationPanel();
+    float tearStrainSetting = 0.5f;
+    bool strainLimitEnabled = false;
+    float strainLimitSetting[3] = { 0.05f, 0.15f, 0.3f }; // 구조/전단/굽힘
+
+    // 난류 바람장
+    WindField windField;
+    bool turbulenceEnabled = false;
+
+    // 겹친 천 (앞쪽에 한 장 더 걸고 천 사이 충돌)
+    void setLayerCloth(bool enabled);
+    std::unique_ptr<SceneCloth> layerCloth;
+    ClothCollisionWorld<SceneCloth> clothCollision;
+
+    // 격자 해상도 전환 (가로 파티클 수, 세로는 비율 유지)
+    void resampleCloth(int width);
+    int gridWidthSetting = 20;
+
+    // 바닥 충돌체 (본 천과 겹친 천 모두)
+    void applyFloorCollider();
+    bool floorEnabled = false;
+    float floorHeight = -1.5f;
+
+    // 큰 버퍼 페이지 배치 (조회가 무거워 1초마다 갱신)
+    std::vector<SceneCloth::BufferPlacement> bufferPlacement;
+    float placementAge = 1e9f;
+
     bool suppressRightClickWind = false;
+
+    // 프레임 예산 (시뮬레이션/업로드/렌더 시간으로 서브스텝/반복/노멀 갱신 단계 조절)
+    void applyQualityLevel();
+    FrameBudget frameBudget;
+    bool frameBudgetEnabled = false;
+    int maxSubstepsSetting = 8;            // 패널 설정 (예산 단계는 이 값을 넘지 않음)
+    FrameBudget::Timing lastFrameTiming;
+    unsigned int renderQueries[2] = { 0, 0 }; // GPU 렌더 시간 (한 프레임 늦게 읽음)
+    long long renderQueryFrames = 0;
+
+    // 빠른 정착 (Shift+S): 렌더는 조각마다 한 번, 그 사이에는 쉬지 않고 시뮬레이션
+    // 1단계는 색칠 병렬 순회로 모든 코어를 쓰고, 멈추면 직렬 순회로 다듬어 실시간 경로와 같은 평형에 맞춤
+    // 충돌체/겹친 천이 없으면 운동 에너지가 꺾일 때마다 속도를 0으로 (운동 감쇠, 평형이 하나라 결과 같음)
+    void startSettle();
+    void cancelSettle();
+    void finishSettle(bool converged);
+    void stepSettle();
+    void drawSettleProgress();
+    void setSettleParallel(bool enabled);
+    bool settling = false;
+    bool settlePolishing = false;   // 직렬 다듬기 단계 (코어가 하나면 처음부터)
+    bool settleKinetic = false;     // 운동 감쇠 사용 여부
+    float settleThreshold = 1e-6f;  // 입자당 운동 에너지 (m^2/s^2)
+    int settleFrames = 0;
+    int settleCalmFrames = 0;       // 연속으로 임계값 아래였던 프레임 수
+    float settleEnergy = 0.0f;
+    float settlePeakEnergy = 0.0f;
+    float settlePrevEnergy = 0.0f;
+    float settleProgress = 0.0f;
+    double settleStartTime = 0.0;
+    double settleLastMs = -1.0;     // 마지막 정착에 걸린 시간 (음수면 아직 없음)
+    int settleLastFrames = 0;
+    bool settleLastConverged = false;
 };
\ No newline at end of file
@@ -1,4 +1,6 @@
 ﻿#include "Cloth.h"
+#include "Parallel.h"
+#include "WindField.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <fstream>
 #include <filesystem>
@@ -6,31 +8,87 @@
 #include <iomanip>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
 
 namespace fs = std::filesystem;
 
 // 시뮬레이션 상수 정의
-const float Cloth::kDamping = 0.99f;
-const int   Cloth::kConstraintIters = 8;
-const float Cloth::kCorrectionFactorStable = 0.22f;
-const float Cloth::kCorrectionFactorWarmup = 0.38f;
-const int   Cloth::kGravityWarmupFrames = 60;
-const float Cloth::kWindStrength = 0.0f;
-const glm::vec3 Cloth::kWindDir = glm::vec3(0.0f, 0.0f, 0.0f);
+template<class Real, class SolveReal>
+const float BasicCloth<Real, SolveReal>::kDamping = 0.99f;
+template<class Real, class SolveReal>
+const int   BasicCloth<Real, SolveReal>::kConstraintIters = 8;
+template<class Real, class SolveReal>
+const int   BasicCloth<Real, SolveReal>::kMinConstraintIters = 2;
+template<class Real, class SolveReal>
+const int   BasicCloth<Real, SolveReal>::kMaxConstraintIters = 24;
+template<class Real, class SolveReal>
+const float BasicCloth<Real, SolveReal>::kResidualHigh = 0.05f;
+template<class Real, class SolveReal>
+const float BasicCloth<Real, SolveReal>::kReferenceStep = 1.0f / 60.0f;
+template<class Real, class SolveReal>
+const float BasicCloth<Real, SolveReal>::kCorrectionFactorStable = 0.22f;
+template<class Real, class SolveReal>
+const float BasicCloth<Real, SolveReal>::kCorrectionFactorWarmup = 0.38f;
+template<class Real, class SolveReal>
+const int   BasicCloth<Real, SolveReal>::kGravityWarmupFrames = 60;
+template<class Real, class SolveReal>
+const float BasicCloth<Real, SolveReal>::kCollisionMargin = 0.01f;
+template<class Real, class SolveReal>
+const int   BasicCloth<Real, SolveReal>::kParallelGrain = 4096;
+template<class Real, class SolveReal>
+const int   BasicCloth<Real, SolveReal>::kPluginBatch = 1024;
+template<class Real, class SolveReal>
+const float BasicCloth<Real, SolveReal>::kContactRequery = 0.5f;
+template<class Real, class SolveReal>
+const float BasicCloth<Real, SolveReal>::kContactSlack = 0.1f;
+template<class Real, class SolveReal>
+const int   BasicCloth<Real, SolveReal>::kMaxCachedColliders = 64;
+template<class Real, class SolveReal>
+const int   BasicCloth<Real, SolveReal>::kFusedBlockParticles = 4096;
 
 // Cloth 생성자
-Cloth::Cloth(int width, int height, float spacing)
-    : numWidth(width), numHeight(height), spacing(spacing)
+template<class Real, class SolveReal>
+BasicCloth<Real, SolveReal>::BasicCloth(int width, int height, float spacing)
+    : BasicCloth(width, height, spacing, 0, height)
 {
+}
+
+template<class Real, class SolveReal>
+BasicCloth<Real, SolveReal>::BasicCloth(int width, int height, float spacing, int rowOffset, int fullHeight)
+    : numWidth(width), numHeight(height), spacing(spacing), gridRowOffset(rowOffset), gridFullHeight(fullHeight)
+{
+    using Clock = std::chrono::steady_clock;
+    auto ms = [](Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<float, std::milli>(b - a).count();
+    };
+
+    const auto t0 = Clock::now();
     initParticles();
+    const auto t1 = Clock::now();
     initSprings();
-
+    const auto t2 = Clock::now();
     buildIndices(numWidth, numHeight);
+    const auto t3 = Clock::now();
+
+    topologyStats.particlesMs = ms(t0, t1);
+    topologyStats.springsMs = ms(t1, t2);
+    topologyStats.indicesMs = ms(t2, t3);
+
+    corners = { getIndex(0, 0), getIndex(numWidth - 1, 0),
+        getIndex(0, numHeight - 1), getIndex(numWidth - 1, numHeight - 1) };
+    if (gridRowOffset == 0) pinAnchors = { corners[0], corners[1] };
 }
 
-Cloth::~Cloth() { destroyGL(); }
+template<class Real, class SolveReal>
+BasicCloth<Real, SolveReal>::~BasicCloth() { destroyGL(); }
 
-void Cloth::destroyGL()
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::destroyGL()
 {
     if (ebo) { glDeleteBuffers(1, &ebo); ebo = 0; }
     if (vboNormal) { glDeleteBuffers(1, &vboNormal); vboNormal = 0; }
@@ -40,7 +98,8 @@ void Cloth::destroyGL()
 }
 
 // OBJ 파일로 천 시뮬레이션 결과 내보내기
-bool Cloth::exportOBJ(const std::string& objPath, const std::string& mtlName, const char* texPath, float uvScale)
+template<class Real, class SolveReal>
+bool BasicCloth<Real, SolveReal>::exportOBJ(const std::string& objPath, const std::string& mtlName, const char* texPath, float uvScale)
 {
     try {
         fs::path objP = fs::path(objPath);
@@ -122,138 +181,870 @@ bool Cloth::exportOBJ(const std::string& objPath, const std::string& mtlName, co
     }
 }
 
+// 현재 상태에 해당하는 스텝 특성 조합
+template<class Real, class SolveReal>
+unsigned BasicCloth<Real, SolveReal>::currentFeatures() const
+{
+    unsigned f = 0;
+    if (fixedCount > 0) f |= kFeatPins;
+    if ((windField || glm::dot(wind.velocity, wind.velocity) > 1e-12f) && wind.airDensity > 0.0f
+        && (wind.dragCoeff != 0.0f || wind.liftCoeff != 0.0f)) f |= kFeatWind;
+    if (!colliders.empty()) f |= kFeatColliders;
+    for (float k : springStiffness)
+    {
+        if (k != 1.0f) { f |= kFeatSpringTypes; break; }
+    }
+    if (frameCount < BasicCloth::kGravityWarmupFrames) f |= kFeatWarmup;
+    return f;
+}
+
+template<class Real, class SolveReal>
+template<std::size_t... I>
+constexpr std::array<typename BasicCloth<Real, SolveReal>::StepFn, sizeof...(I)> BasicCloth<Real, SolveReal>::makeStepTable(std::index_sequence<I...>)
+{
+    return { &BasicCloth::template stepKernel<static_cast<unsigned>(I)>... };
+}
+
+template<class Real, class SolveReal>
+template<std::size_t... I>
+constexpr std::array<typename BasicCloth<Real, SolveReal>::SolveFn, sizeof...(I)> BasicCloth<Real, SolveReal>::makeSolveTable(std::index_sequence<I...>)
+{
+    return { &BasicCloth::template solveKernel<static_cast<unsigned>(I)>... };
+}
+
 // 매 프레임 시뮬레이션을 업데이트
-void Cloth::update(float deltaTime)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::update(float deltaTime)
+{
+    static constexpr auto table = makeStepTable(std::make_index_sequence<kFeatCombinations>{});
+
+    if (windField)
+    {
+        windField->advance(simTime);
+    }
+
+    (this->*table[currentFeatures()])(deltaTime);
+
+    if (tearStrain > 0.0f)
+    {
+        processTears();
+    }
+}
+
+// 서브스텝 길이: 최대 속도로 spacing * cfl 이상 못 가도록, 변형률이 급증하면 절반
+// 직전 간격의 2배 이상으로는 늘리지 않아 간격이 출렁이지 않게 함
+template<class Real, class SolveReal>
+float BasicCloth<Real, SolveReal>::nextStepSize(float remaining) const
+{
+    float dt = timeStep.maxStep;
+    if (lastMaxSpeed > 1e-6f && spacing > 0.0f)
+    {
+        dt = std::min(dt, timeStep.cflNumber * spacing / lastMaxSpeed);
+    }
+    if (lastStepDt > 0.0f)
+    {
+        if (lastStrainGrowth > timeStep.strainGrowthLimit) dt = std::min(dt, 0.5f * lastStepDt);
+        dt = std::min(dt, 2.0f * lastStepDt);
+    }
+    dt = std::max(dt, timeStep.minStep);
+
+    // 남은 시간을 같은 길이로 나눠 끝에 자투리 스텝이 생기지 않게
+    const float n = std::ceil(remaining / dt - 1e-4f);
+    return remaining / std::max(1.0f, n);
+}
+
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::advance(float frameTime)
+{
+    lastSubsteps = 0;
+    float remaining = frameTime;
+    while (remaining > 1e-6f && lastSubsteps < timeStep.maxSubsteps)
+    {
+        const float dt = nextStepSize(remaining);
+        update(dt);
+        remaining -= dt;
+        lastSubsteps++;
+    }
+}
+
+template<class Real, class SolveReal>
+float BasicCloth<Real, SolveReal>::getKineticEnergy() const
 {
-    float t = 1.0f;
-    if (frameCount < Cloth::kGravityWarmupFrames)
+    if (particles.empty() || lastStepDt <= 0.0f) return 0.0f;
+    double sum = 0.0;
+    for (const Particle& p : particles)
     {
-        t = static_cast<float>(frameCount) / static_cast<float>(Cloth::kGravityWarmupFrames);
+        const Vec3 d = p.pos - p.prevPos;
+        sum += static_cast<double>(glm::dot(d, d));
     }
-    float gravityScale = t;
+    const double invDt = 1.0 / static_cast<double>(lastStepDt);
+    return static_cast<float>(0.5 * sum * invDt * invDt / static_cast<double>(particles.size()));
+}
 
-    applyGravity(glm::vec3(0.0f, -9.8f * gravityScale, 0.0f));
+// 힘 누적 + Verlet 통합 + 제약 + 충돌 + 노멀 (특성별로 분기 없는 경로)
+template<class Real, class SolveReal>
+template<unsigned Features>
+void BasicCloth<Real, SolveReal>::stepKernel(float deltaTime)
+{
+    constexpr bool kPins = (Features & kFeatPins) != 0;
+    constexpr bool kWind = (Features & kFeatWind) != 0;
+    constexpr bool kColliders = (Features & kFeatColliders) != 0;
+    constexpr bool kWarmup = (Features & kFeatWarmup) != 0;
 
-    if (Cloth::kWindStrength > 0.0f)
+    Vec3 force(Real(0), Real(-9.8f), Real(0));
+    if constexpr (kWarmup)
+    {
+        force.y *= Real(static_cast<float>(frameCount) / static_cast<float>(BasicCloth::kGravityWarmupFrames));
+    }
+    // pos - prevPos는 직전 스텝 길이 기준 이동량이므로 간격이 바뀌면 비율만큼 늘리거나 줄임
+    const float prevDt = (lastStepDt > 0.0f) ? lastStepDt : deltaTime;
+    if constexpr (kWind)
+    {
+        accumulateAerodynamics(prevDt);
+    }
+    if (!forceFields.empty())
     {
-        glm::vec3 wdir = (glm::length(Cloth::kWindDir) > 1e-6f)
-            ? glm::normalize(Cloth::kWindDir)
-            : glm::vec3(0.0f);
-        glm::vec3 wind = wdir * (9.8f * Cloth::kWindStrength);
-        for (int i = 0; i < static_cast<int>(particles.size()); i++)
+        runForceFields(prevDt);
+    }
+
+    const Real dt2 = Real(deltaTime * deltaTime);
+    // 감쇠는 kReferenceStep당 kDamping이 되도록 스텝 길이에 맞춰 환산
+    const Real carry = Real(std::pow(BasicCloth::kDamping, deltaTime / BasicCloth::kReferenceStep) * (deltaTime / prevDt));
+    Real maxStep2 = Real(0);
+
+    // 종류별 일정: 이번 스텝에 돌 종류와 종류별 반복 상한
+    constexpr int kClasses = static_cast<int>(SpringType::Count);
+    unsigned dueClasses = 0;
+    int classIters[kClasses];
+    for (int c = 0; c < kClasses; c++)
+    {
+        const SpringSchedule& sc = springSchedule[c];
+        classIters[c] = (sc.iterations > 0) ? sc.iterations : BasicCloth::kMaxConstraintIters;
+        if (sc.interval <= 1 || frameCount % sc.interval == 0) dueClasses |= 1u << c;
+    }
+    auto classMaskAt = [&](int iteration) {
+        unsigned mask = 0;
+        for (int c = 0; c < kClasses; c++)
         {
-            particles[i].applyForce(wind);
+            if ((dueClasses & (1u << c)) && iteration < classIters[c]) mask |= 1u << c;
         }
+        return mask;
+    };
+
+    const int maxIters = (iterationCap > 0) ? std::min(iterationCap, BasicCloth::kMaxConstraintIters) : BasicCloth::kMaxConstraintIters;
+    const bool normalsDue = normalInterval <= 1 || frameCount % normalInterval == 0;
+
+    // 융합 파이프라인: 통합 + 첫 순회를 행 블록마다 이어서, 뒤에서 위치를 바꾸는 단계가 없으면 노멀은 마지막 순회에 합침
+    const bool fused = fusedPipeline && !parallelSolve && fusedLayoutValid();
+    const int fusedIters = std::clamp(fusedIterations, 1, maxIters);
+    const bool fuseNormals = fused && normalsDue && !kColliders && constraintHooks.empty()
+        && strainLimit[0] <= 0.0f && strainLimit[1] <= 0.0f && strainLimit[2] <= 0.0f;
+
+    const SolveStats baseline = lastSolveStats;
+    int iters = 0;
+    SolveStats stats = baseline;
+    bool normalsDone = false;
+    lastSpringVisits = 0;
+    lastLocalSprings = 0;
+    if (fused)
+    {
+        normalsDone = fuseNormals && fusedIters == 1 && localSeeds.empty();
+        const SolveStats first = fusedSweep<Features>(classMaskAt(0), true, normalsDone, force, carry, dt2, maxStep2);
+        if (first.visited > 0) stats = first;
+        lastSpringVisits += first.visited;
+        iters = 1;
+        if constexpr (kColliders)
+        {
+            projectCachedContacts();
+        }
+    }
+    else if (parallelSolve)
+    {
+        std::mutex merge;
+        parallelFor(static_cast<int>(particles.size()), [&](int begin, int end) {
+            Real localMax2 = Real(0);
+            integrateRange<Features>(begin, end, force, carry, dt2, localMax2);
+            std::lock_guard<std::mutex> lock(merge);
+            maxStep2 = std::max(maxStep2, localMax2);
+        }, BasicCloth::kParallelGrain);
     }
+    else
+    {
+        integrateRange<Features>(0, particles.size(), force, carry, dt2, maxStep2);
+    }
+    lastMaxSpeed = static_cast<float>(std::sqrt(maxStep2)) / deltaTime;
+    lastStepDt = deltaTime;
 
-    for (int i = 0; i < static_cast<int>(particles.size()); i++)
+    // 상호작용 지점 주변을 먼저 국소 반복으로 줄여 두면 전역 적응 반복이 낮게 유지됨
+    if (!localSeeds.empty())
+    {
+        lastSpringVisits += solveLocal();
+    }
+
+    if (fused)
+    {
+        while (iters < fusedIters)
+        {
+            const unsigned classMask = classMaskAt(iters);
+            if (classMask == 0) break;
+            iters++;
+
+            normalsDone = fuseNormals && iters == fusedIters;
+            stats = normalsDone
+                ? fusedSweep<Features>(classMask, false, true, force, carry, dt2, maxStep2)
+                : solveKernel<Features>(classMask);
+            lastSpringVisits += stats.visited;
+            if constexpr (kColliders)
+            {
+                projectCachedContacts();
+            }
+        }
+    }
+    else
+    {
+        // 수렴은 이번 스텝 안에서만 판단: 직전 순회가 바꾼 최대/RMS 변형률을 이번 스텝 첫 순회 값으로 나눈 잔차
+        // (쉬고 있는 천도 핀/굽힘 충돌로 변형률이 남으므로 절대값이 아니라 변화량으로 봄, 잔차는 순회 안에서 같이 측정)
+        SolveStats first, prev;
+        unsigned prevMask = 0;
+        while (iters < maxIters)
+        {
+            const unsigned classMask = classMaskAt(iters);
+            if (classMask == 0) break;
+
+            stats = solveKernel<Features>(classMask);
+            lastSpringVisits += stats.visited;
+            iters++;
+            if constexpr (kColliders)
+            {
+                projectCachedContacts();
+            }
+
+            // 종류 구성이 바뀐 순회끼리는 비교하지 않고 거기서 다시 시작
+            float residual = 1.0f;
+            if (classMask == prevMask)
+            {
+                const float dMax = std::fabs(stats.maxStrain - prev.maxStrain) / std::max(first.maxStrain, 1e-6f);
+                const float dRms = std::fabs(stats.rmsStrain - prev.rmsStrain) / std::max(first.rmsStrain, 1e-6f);
+                residual = std::max(dMax, dRms);
+            }
+            else
+            {
+                first = stats;
+                prevMask = classMask;
+            }
+            prev = stats;
+
+            if (iters >= BasicCloth::kMinConstraintIters && residual <= solverTolerance) break;
+            if (iters >= BasicCloth::kConstraintIters && residual <= BasicCloth::kResidualHigh) break;
+        }
+    }
+    lastIterations = iters;
+    lastSolveStats = stats;
+    lastStrainGrowth = stats.maxStrain - baseline.maxStrain;
+
+    if (strainLimit[0] > 0.0f || strainLimit[1] > 0.0f || strainLimit[2] > 0.0f)
+    {
+        limitStrain();
+    }
+
+    if (!constraintHooks.empty())
     {
-        particles[i].updateVerlet(deltaTime, Cloth::kDamping);
+        runConstraintHooks(deltaTime);
     }
 
-    for (int iter = 0; iter < Cloth::kConstraintIters; iter++)
+    if constexpr (kColliders)
     {
-        satisfyConstraints();
+        resolveCollisions<kPins>();
     }
 
-    computeNormals();
+    positionVersion++;
+    if (normalsDone) normalVersion = positionVersion; // 마지막 순회에서 이미 계산
+    if (normalsDue) computeNormals();
 
+    simTime += deltaTime;
     frameCount++;
 }
 
+// 삼각형별 항력/양력을 계산해 세 정점의 가속도에 분배
+// 인덱스 버퍼를 8개씩 묶어 레인 배열로 모은 뒤 분기 없는 루프로 계산 (자동 벡터화)
+// 판 법선 압력 모델: F = q*A*c*(Cd*c*r + Cl*(n - c*r)), q = 0.5*rho*|v|^2, c = |cos(법선, 상대풍)|
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::accumulateAerodynamics(float deltaTime)
+{
+    constexpr int kLanes = 8;
+    const size_t numTris = indices.size() / 3;
+    if (numTris == 0 || deltaTime <= 0.0f) return;
+
+    const float invDt3 = 1.0f / (3.0f * deltaTime);
+    const float vertexMass = std::max(1e-6f, wind.arealDensity * spacing * spacing);
+    const float invMass3 = 1.0f / (3.0f * vertexMass);
+    const float halfRho = 0.5f * wind.airDensity;
+    const float cd = wind.dragCoeff;
+    const float cl = wind.liftCoeff;
+    const glm::vec3 w = wind.velocity;
+
+    alignas(32) float e1x[kLanes], e1y[kLanes], e1z[kLanes];
+    alignas(32) float e2x[kLanes], e2y[kLanes], e2z[kLanes];
+    alignas(32) float rx[kLanes], ry[kLanes], rz[kLanes];
+    alignas(32) float fx[kLanes], fy[kLanes], fz[kLanes];
+
+    for (size_t base = 0; base < numTris; base += kLanes)
+    {
+        const int lanes = static_cast<int>(std::min<size_t>(kLanes, numTris - base));
+
+        // 모으기: 남는 레인은 마지막 삼각형을 복제하고 결과는 버림
+        for (int l = 0; l < kLanes; l++)
+        {
+            const unsigned int* tri = &indices[(base + std::min(l, lanes - 1)) * 3];
+            const Particle& a = particles[tri[0]];
+            const Particle& b = particles[tri[1]];
+            const Particle& c = particles[tri[2]];
+            // 차이는 저장 정밀도로 구한 뒤 float로 (힘 계산은 정밀도와 무관하게 float)
+            glm::vec3 e1(b.pos - a.pos);
+            glm::vec3 e2(c.pos - a.pos);
+            glm::vec3 wl = w;
+            if (windField)
+            {
+                // 난류: 삼각형 중심에서 바람장 샘플
+                wl += windField->sample(glm::vec3((a.pos + b.pos + c.pos) * (Real(1) / Real(3))));
+            }
+            glm::vec3 rel = wl - glm::vec3(((a.pos - a.prevPos) + (b.pos - b.prevPos) + (c.pos - c.prevPos)) * Real(invDt3));
+            e1x[l] = e1.x; e1y[l] = e1.y; e1z[l] = e1.z;
+            e2x[l] = e2.x; e2y[l] = e2.y; e2z[l] = e2.z;
+            rx[l] = rel.x; ry[l] = rel.y; rz[l] = rel.z;
+        }
+
+        for (int l = 0; l < kLanes; l++)
+        {
+            float nx = e1y[l] * e2z[l] - e1z[l] * e2y[l];
+            float ny = e1z[l] * e2x[l] - e1x[l] * e2z[l];
+            float nz = e1x[l] * e2y[l] - e1y[l] * e2x[l];
+            float nLen = std::sqrt(nx * nx + ny * ny + nz * nz);
+            float r2 = rx[l] * rx[l] + ry[l] * ry[l] + rz[l] * rz[l];
+            float rLen = std::sqrt(r2);
+
+            float invN = (nLen > 1e-12f) ? 1.0f / nLen : 0.0f;
+            float invR = (rLen > 1e-6f) ? 1.0f / rLen : 0.0f;
+            float ux = rx[l] * invR, uy = ry[l] * invR, uz = rz[l] * invR;
+            nx *= invN; ny *= invN; nz *= invN;
+
+            // 바람이 향하는 쪽으로 법선을 뒤집음
+            float cosT = nx * ux + ny * uy + nz * uz;
+            float sgn = (cosT < 0.0f) ? -1.0f : 1.0f;
+            float c = cosT * sgn;
+            nx *= sgn; ny *= sgn; nz *= sgn;
+
+            float qAc = halfRho * r2 * (0.5f * nLen) * c;
+            float drag = cd * c;
+            fx[l] = qAc * (drag * ux + cl * (nx - c * ux));
+            fy[l] = qAc * (drag * uy + cl * (ny - c * uy));
+            fz[l] = qAc * (drag * uz + cl * (nz - c * uz));
+        }
+
+        // 분배
+        for (int l = 0; l < lanes; l++)
+        {
+            const unsigned int* tri = &indices[(base + l) * 3];
+            Vec3 a(fx[l] * invMass3, fy[l] * invMass3, fz[l] * invMass3);
+            particles[tri[0]].acceleration += a;
+            particles[tri[1]].acceleration += a;
+            particles[tri[2]].acceleration += a;
+        }
+    }
+}
+
 // 모든 파티클에 중력을 적용
-void Cloth::applyGravity(const glm::vec3& gravity)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::applyGravity(const glm::vec3& gravity)
 {
     for (int i = 0; i < static_cast<int>(particles.size()); i++)
     {
-        particles[i].applyForce(gravity);
+        particles[i].applyForce(Vec3(gravity));
     }
 }
 
 // 제약 조건(스프링)을 만족
-void Cloth::satisfyConstraints()
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::satisfyConstraints()
 {
-    float factor = (frameCount < Cloth::kGravityWarmupFrames)
-        ? Cloth::kCorrectionFactorWarmup
-        : Cloth::kCorrectionFactorStable;
+    static constexpr auto table = makeSolveTable(std::make_index_sequence<kFeatCombinations>{});
+    (this->*table[currentFeatures()])((1u << static_cast<int>(SpringType::Count)) - 1);
+}
+
+// classMask에 든 종류의 스프링 구간을 한 번씩 순회 (핀/종류별 강성/워밍업 계수는 컴파일 타임에 결정)
+// 보정 전 상대 변형률의 최대/RMS를 같은 루프에서 누적해 반환
+template<class Real, class SolveReal>
+template<unsigned Features>
+typename BasicCloth<Real, SolveReal>::SolveStats BasicCloth<Real, SolveReal>::solveKernel(unsigned classMask)
+{
+    constexpr bool kSpringTypes = (Features & kFeatSpringTypes) != 0;
+    const SolveReal factor = (Features & kFeatWarmup)
+        ? BasicCloth::kCorrectionFactorWarmup
+        : BasicCloth::kCorrectionFactorStable;
+
+    float maxStrain = 0.0f;
+    float sumSq = 0.0f;
+    int visited = 0;
+    for (int c = 0; c < static_cast<int>(SpringType::Count); c++)
+    {
+        if (!(classMask & (1u << c))) continue;
+
+        // 종류별로 묶여 있으므로 강성은 구간마다 한 번만 정함
+        SolveReal k = factor;
+        if constexpr (kSpringTypes)
+        {
+            k *= springStiffness[c];
+        }
+        if (parallelSolve)
+        {
+            solveClassColored<Features>(c, k, maxStrain, sumSq);
+        }
+        else
+        {
+            solveSpringRange<Features>(springClassStart[c], springClassStart[c + 1], k, maxStrain, sumSq);
+        }
+        visited += springClassStart[c + 1] - springClassStart[c];
+    }
+
+    SolveStats stats;
+    stats.maxStrain = maxStrain;
+    stats.rmsStrain = (visited == 0) ? 0.0f : std::sqrt(sumSq / static_cast<float>(visited));
+    stats.visited = visited;
+    return stats;
+}
+
+// 스프링 하나를 강성 k로 보정하고 보정 전 변형률을 최대/제곱합에 누적
+template<class Real, class SolveReal>
+template<unsigned Features>
+inline void BasicCloth<Real, SolveReal>::solveSpring(const Spring& s, SolveReal k, float& maxStrain, float& sumSq)
+{
+    constexpr bool kPins = (Features & kFeatPins) != 0;
+    using SolveVec3 = glm::vec<3, SolveReal>;
+
+    Particle& p1 = particles[s.p1];
+    Particle& p2 = particles[s.p2];
+
+    // 차이 벡터를 저장 정밀도로 구한 뒤 SolveReal로 바꿔 계산 (혼합 모드에서도 원점 거리와 무관)
+    SolveVec3 delta(p2.pos - p1.pos);
+    SolveReal dist = glm::length(delta);
+    if (dist < SolveReal(1e-8f))
+    {
+        return;
+    }
+
+    const SolveReal rest = s.restLength;
+    SolveReal diff = (dist - rest) / dist;
+    Vec3 correction(delta * (k * diff));
 
-    for (int i = 0; i < static_cast<int>(springs.size()); i++)
+    float strain = static_cast<float>(std::fabs(dist - rest) / std::max(rest, SolveReal(1e-8f)));
+    maxStrain = std::max(maxStrain, strain);
+    sumSq += strain * strain;
+
+    if constexpr (kPins)
+    {
+        p1.pos += correction * (p1.isFixed ? Real(0) : Real(1));
+        p2.pos -= correction * (p2.isFixed ? Real(0) : Real(1));
+    }
+    else
     {
-        Spring& s = springs[i];
-        Particle& p1 = particles[s.p1];
-        Particle& p2 = particles[s.p2];
+        p1.pos += correction;
+        p2.pos -= correction;
+    }
+}
 
-        glm::vec3 delta = p2.pos - p1.pos;
-        float dist = glm::length(delta);
-        if (dist < 1e-8f)
+// 스프링 [begin, end)를 강성 k로 한 번 순회하며 변형률 최대/제곱합 누적
+template<class Real, class SolveReal>
+template<unsigned Features>
+void BasicCloth<Real, SolveReal>::solveSpringRange(int begin, int end, SolveReal k, float& maxStrain, float& sumSq)
+{
+    for (int i = begin; i < end; i++)
+    {
+        solveSpring<Features>(springs[i], k, maxStrain, sumSq);
+    }
+}
+
+// 종류 c를 색 묶음 순서로 한 번 순회 (묶음 안은 끝점을 공유하지 않아 병렬, 구간별 잔차는 잠금으로 합침)
+template<class Real, class SolveReal>
+template<unsigned Features>
+void BasicCloth<Real, SolveReal>::solveClassColored(int c, SolveReal k, float& maxStrain, float& sumSq)
+{
+    if (solveColorsDirty || solveColorOrder.size() != springs.size()) buildSolveColors();
+
+    std::mutex merge;
+    for (int b = solveClassBatch[c]; b < solveClassBatch[c + 1]; b++)
+    {
+        const int base = solveColorStart[b];
+        const int count = solveColorStart[b + 1] - base;
+        if (solveBatchSerial[b])
         {
+            for (int j = base; j < base + count; j++)
+                solveSpring<Features>(springs[solveColorOrder[j]], k, maxStrain, sumSq);
             continue;
         }
+        parallelFor(count, [&](int begin, int end) {
+            float localMax = 0.0f, localSum = 0.0f;
+            for (int j = base + begin; j < base + end; j++)
+                solveSpring<Features>(springs[solveColorOrder[j]], k, localMax, localSum);
+            std::lock_guard<std::mutex> lock(merge);
+            maxStrain = std::max(maxStrain, localMax);
+            sumSq += localSum;
+        }, BasicCloth::kParallelGrain);
+    }
+}
+
+// 종류별로 양 끝점을 공유하지 않게 탐욕적 색칠 (64색을 넘으면 직렬 묶음), 종류 안에서는 색 -> 원래 순서
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::buildSolveColors()
+{
+    constexpr int kClasses = static_cast<int>(SpringType::Count);
+    constexpr int kMaxColors = 64;
 
-        float diff = (dist - s.restLength) / dist;
-        glm::vec3 correction = delta * (factor * diff);
+    solveColorOrder.clear();
+    solveColorOrder.reserve(springs.size());
+    solveColorStart.assign(1, 0);
+    solveBatchSerial.clear();
 
-        if (!p1.isFixed) p1.pos += correction;
-        if (!p2.isFixed) p2.pos -= correction;
+    std::vector<std::uint64_t> used(particles.size(), 0);
+    std::vector<int> color;
+    for (int c = 0; c < kClasses; c++)
+    {
+        solveClassBatch[c] = static_cast<int>(solveBatchSerial.size());
+        const int begin = springClassStart[c], end = springClassStart[c + 1];
+        color.assign(end - begin, 0);
+        int count[kMaxColors + 1] = {};
+        for (int i = begin; i < end; i++)
+        {
+            const Spring& s = springs[i];
+            const std::uint64_t busy = used[s.p1] | used[s.p2];
+            int col = kMaxColors;
+            if (~busy != 0)
+            {
+                col = 0;
+                while (busy & (std::uint64_t(1) << col)) col++;
+                used[s.p1] |= std::uint64_t(1) << col;
+                used[s.p2] |= std::uint64_t(1) << col;
+            }
+            color[i - begin] = col;
+            count[col]++;
+        }
+        for (int i = begin; i < end; i++)
+        {
+            used[springs[i].p1] = 0;
+            used[springs[i].p2] = 0;
+        }
+
+        for (int col = 0; col <= kMaxColors; col++)
+        {
+            if (count[col] == 0) continue;
+            for (int i = begin; i < end; i++)
+                if (color[i - begin] == col) solveColorOrder.push_back(i);
+            solveColorStart.push_back(static_cast<int>(solveColorOrder.size()));
+            solveBatchSerial.push_back(col == kMaxColors ? 1 : 0);
+        }
     }
+    solveClassBatch[kClasses] = static_cast<int>(solveBatchSerial.size());
+    solveColorsDirty = false;
 }
 
-// 삼각형 메시를 렌더링
-void Cloth::draw()
+// 파티클 [begin, end) Verlet 통합 (누적 가속도는 비움)
+template<class Real, class SolveReal>
+template<unsigned Features>
+void BasicCloth<Real, SolveReal>::integrateRange(size_t begin, size_t end, const Vec3& force, Real carry, Real dt2, Real& maxStep2)
 {
-    drawTriangles();
+    constexpr bool kPins = (Features & kFeatPins) != 0;
+    for (size_t i = begin; i < end; i++)
+    {
+        Particle& p = particles[i];
+        Vec3 step = (p.pos - p.prevPos) * carry + (p.acceleration + force) * dt2;
+        if constexpr (kPins)
+        {
+            step *= p.isFixed ? Real(0) : Real(1);
+        }
+        maxStep2 = std::max(maxStep2, glm::dot(step, step));
+        p.prevPos = p.pos;
+        p.pos += step;
+        p.acceleration = Vec3(Real(0));
+    }
 }
 
-// 인덱스 버퍼와 UV 데이터 생성
-void Cloth::buildIndices(int w, int h)
+// 격자 스프링이 initSprings의 종류별/행별 배치 그대로인지 (찢어지거나 메시면 false)
+template<class Real, class SolveReal>
+bool BasicCloth<Real, SolveReal>::fusedLayoutValid() const
 {
-    gridW = w;
-    gridH = h;
-    indices.clear();
-    indices.reserve((w - 1) * (h - 1) * 6);
+    constexpr int kClasses = static_cast<int>(SpringType::Count);
+    const int h = numHeight;
+    if (!gridTopology || numWidth < 2 || h < 2 || particles.size() != static_cast<size_t>(numWidth) * h
+        || springRowStart.size() != static_cast<size_t>(kClasses) * (h + 1))
+        return false;
+    for (int c = 0; c < kClasses; c++)
+    {
+        if (springRowStart[c * (h + 1)] != springClassStart[c] || springRowStart[c * (h + 1) + h] != springClassStart[c + 1])
+            return false;
+    }
+    return true;
+}
 
-    for (int y = 0; y < h - 1; y++)
+// 행 블록 단위 순회 (격자 전용): 스프링은 출발 행에서 아래로 최대 2행까지만 닿으므로
+// integrate면 블록을 통합한 뒤 끝점이 모두 통합된 출발 행까지만 풀고,
+// normals면 더 이상 바뀌지 않는 행(풀린 출발 행보다 두 줄 위까지)의 노멀을 바로 뒤따라 계산
+template<class Real, class SolveReal>
+template<unsigned Features>
+typename BasicCloth<Real, SolveReal>::SolveStats BasicCloth<Real, SolveReal>::fusedSweep(unsigned classMask, bool integrate, bool normals,
+    const Vec3& force, Real carry, Real dt2, Real& maxStep2)
+{
+    constexpr bool kSpringTypes = (Features & kFeatSpringTypes) != 0;
+    constexpr int kClasses = static_cast<int>(SpringType::Count);
+    const SolveReal factor = (Features & kFeatWarmup)
+        ? BasicCloth::kCorrectionFactorWarmup
+        : BasicCloth::kCorrectionFactorStable;
+    SolveReal k[kClasses];
+    for (int c = 0; c < kClasses; c++)
     {
-        for (int x = 0; x < w - 1; x++)
+        k[c] = factor;
+        if constexpr (kSpringTypes)
         {
-            unsigned int i0 = y * w + x;
-            unsigned int i1 = i0 + 1;
-            unsigned int i2 = i0 + w;
-            unsigned int i3 = i2 + 1;
+            k[c] *= springStiffness[c];
+        }
+    }
+
+    const int W = numWidth, H = numHeight;
+    const int blockRows = std::max(1, BasicCloth::kFusedBlockParticles / W);
+    auto rowStart = [&](int c, int y) { return springRowStart[c * (H + 1) + y]; };
 
-            indices.push_back(i0);
-            indices.push_back(i1);
-            indices.push_back(i2);
+    float maxStrain = 0.0f;
+    float sumSq = 0.0f;
+    int visited = 0;
+    int solvedRows = 0, normalRows = 0;
+    for (int y0 = 0; y0 < H; y0 += blockRows)
+    {
+        const int y1 = std::min(H, y0 + blockRows);
+        if (integrate)
+        {
+            integrateRange<Features>(static_cast<size_t>(y0) * W, static_cast<size_t>(y1) * W, force, carry, dt2, maxStep2);
+        }
 
-            indices.push_back(i1);
-            indices.push_back(i3);
-            indices.push_back(i2);
+        const int ready = (!integrate || y1 == H) ? y1 : std::max(solvedRows, y1 - 2);
+        for (int c = 0; c < kClasses; c++)
+        {
+            if (!(classMask & (1u << c))) continue;
+            solveSpringRange<Features>(rowStart(c, solvedRows), rowStart(c, ready), k[c], maxStrain, sumSq);
+            visited += rowStart(c, ready) - rowStart(c, solvedRows);
+        }
+        solvedRows = ready;
+
+        if (normals)
+        {
+            const int done = (solvedRows == H) ? H : std::max(normalRows, solvedRows - 1);
+            computeNormalsGridRows(normalRows, done);
+            normalRows = done;
         }
     }
 
-    uvs.resize(w * h);
-    for (int y = 0; y < h; y++)
+    SolveStats stats;
+    stats.maxStrain = maxStrain;
+    stats.rmsStrain = (visited == 0) ? 0.0f : std::sqrt(sumSq / static_cast<float>(visited));
+    stats.visited = visited;
+    return stats;
+}
+
+// 파티클 하나를 충돌체 하나 밖으로 밀어냄 (표면에서 slack 안이면 접촉으로 보고 true)
+template<class Real, class SolveReal>
+bool BasicCloth<Real, SolveReal>::projectContact(Particle& p, const Collider& c, Real slack)
+{
+    const Real margin = BasicCloth::kCollisionMargin;
+    const Vec3 center(c.center);
+    if (c.type == Collider::Type::Plane)
+    {
+        const Vec3 normal(c.normal);
+        Real d = glm::dot(p.pos - center, normal);
+        if (d < margin)
+            p.pos += normal * (margin - d);
+        return d < margin + slack;
+    }
+
+    Vec3 d = p.pos - center;
+    Real r = Real(c.radius + BasicCloth::kCollisionMargin);
+    Real len2 = glm::dot(d, d);
+    if (len2 < r * r && len2 > Real(1e-12f))
+        p.pos = center + d * (r / std::sqrt(len2));
+    return len2 < (r + slack) * (r + slack);
+}
+
+// 표면까지 거리가 margin + range 안인 충돌체 비트 (앞쪽 kMaxCachedColliders개만)
+template<class Real, class SolveReal>
+std::uint64_t BasicCloth<Real, SolveReal>::queryNearColliders(const Vec3& pos, Real range) const
+{
+    const Real reach = Real(BasicCloth::kCollisionMargin) + range;
+    const int count = std::min(static_cast<int>(colliders.size()), BasicCloth::kMaxCachedColliders);
+    std::uint64_t mask = 0;
+    for (int k = 0; k < count; k++)
     {
-        for (int x = 0; x < w; x++)
+        const Collider& c = colliders[k];
+        bool near;
+        if (c.type == Collider::Type::Plane)
+        {
+            near = glm::dot(pos - Vec3(c.center), Vec3(c.normal)) < reach;
+        }
+        else
+        {
+            const Vec3 d = pos - Vec3(c.center);
+            const Real r = Real(c.radius) + reach;
+            near = glm::dot(d, d) < r * r;
+        }
+        if (near) mask |= std::uint64_t(1) << k;
+    }
+    return mask;
+}
+
+// 충돌체 밖으로 파티클을 밀어냄 (접촉 캐시 갱신)
+// 마지막 질의 위치에서 requery 거리 이상 움직인 파티클만 전체 충돌체를 다시 훑고,
+// 나머지는 그때 가까웠던 충돌체만 검사 (충돌체는 움직이지 않으므로 그 밖의 충돌체엔 닿을 수 없음)
+template<class Real, class SolveReal>
+template<bool HasPins>
+void BasicCloth<Real, SolveReal>::resolveCollisions()
+{
+    const int n = static_cast<int>(particles.size());
+    if (contactColliderVersion != colliderVersion)
+    {
+        contactQueryPos.clear();
+        contactNear.clear();
+        contactColliderVersion = colliderVersion;
+    }
+    if (contactQueryPos.size() != static_cast<size_t>(n))
+    {
+        contactQueryPos.resize(n, Vec3(Real(1e30f)));
+        contactNear.resize(n, 0);
+    }
+
+    const Real unit = Real(std::max(spacing, 1e-3f));
+    const Real requery = unit * Real(BasicCloth::kContactRequery);
+    const Real slack = unit * Real(BasicCloth::kContactSlack);
+    const int numColliders = static_cast<int>(colliders.size());
+
+    cachedContacts.clear();
+    int requeried = 0;
+    for (int i = 0; i < n; i++)
+    {
+        Particle& p = particles[i];
+        if constexpr (HasPins)
+        {
+            if (p.isFixed) continue;
+        }
+
+        const Vec3 moved = p.pos - contactQueryPos[i];
+        if (glm::dot(moved, moved) > requery * requery)
+        {
+            contactNear[i] = queryNearColliders(p.pos, requery);
+            contactQueryPos[i] = p.pos;
+            requeried++;
+        }
+
+        for (std::uint64_t mask = contactNear[i]; mask != 0; mask &= mask - 1)
+        {
+            const int k = std::countr_zero(mask);
+            if (projectContact(p, colliders[k], slack)) cachedContacts.push_back({ i, k });
+        }
+        for (int k = BasicCloth::kMaxCachedColliders; k < numColliders; k++)
         {
-            float u = static_cast<float>(x) / static_cast<float>(w - 1);
-            float v = static_cast<float>(y) / static_cast<float>(h - 1);
-            uvs[y * w + x] = glm::vec2(u, v);
+            if (projectContact(p, colliders[k], slack)) cachedContacts.push_back({ i, k });
         }
     }
+
+    lastContactStats.contacts = static_cast<int>(cachedContacts.size());
+    lastContactStats.requeried = requeried;
+}
+
+// 직전 스텝의 접촉을 제약 반복 안에서 같이 투영 (스프링이 충돌체 안으로 당긴 걸 매 반복 되돌려 떨림 감소)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::projectCachedContacts()
+{
+    if (contactColliderVersion != colliderVersion) return;
+    const size_t n = particles.size();
+    for (const ColliderContact& ct : cachedContacts)
+    {
+        if (static_cast<size_t>(ct.particle) >= n) continue;
+        Particle& p = particles[ct.particle];
+        if (p.isFixed) continue;
+        projectContact(p, colliders[ct.collider], Real(0));
+    }
+}
+
+// 삼각형 메시를 렌더링
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::draw()
+{
+    drawTriangles();
+}
+
+// 파티클/스프링/인덱스 버퍼의 페이지 배치 조회 (/proc 읽기와 시스템 호출이 있어 가끔만 부를 것)
+template<class Real, class SolveReal>
+std::vector<typename BasicCloth<Real, SolveReal>::BufferPlacement> BasicCloth<Real, SolveReal>::queryBufferPlacement() const
+{
+    return {
+        { "particles", queryPagePlacement(particles.data(), particles.capacity() * sizeof(Particle)) },
+        { "springs", queryPagePlacement(springs.data(), springs.capacity() * sizeof(Spring)) },
+        { "indices", queryPagePlacement(indices.data(), indices.capacity() * sizeof(unsigned int)) },
+    };
+}
+
+// 인덱스 버퍼와 UV 데이터 생성 (크기를 미리 정하고 행 단위 병렬로 채움)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::buildIndices(int w, int h)
+{
+    gridW = w;
+    gridH = h;
+    bvhTopologyDirty = true;
+    indices.resize(static_cast<size_t>(std::max(0, w - 1)) * std::max(0, h - 1) * 6);
+    uvs.resize(static_cast<size_t>(w) * h);
+
+    const int rowGrain = std::max(1, BasicCloth::kParallelGrain / std::max(1, w));
+    parallelFor(h, [&](int begin, int end) {
+        for (int y = begin; y < end; y++)
+        {
+            if (y < h - 1)
+            {
+                unsigned int* out = indices.data() + static_cast<size_t>(y) * (w - 1) * 6;
+                for (int x = 0; x < w - 1; x++)
+                {
+                    unsigned int i0 = y * w + x;
+                    unsigned int i1 = i0 + 1;
+                    unsigned int i2 = i0 + w;
+                    unsigned int i3 = i2 + 1;
+
+                    *out++ = i0;
+                    *out++ = i1;
+                    *out++ = i2;
+
+                    *out++ = i1;
+                    *out++ = i3;
+                    *out++ = i2;
+                }
+            }
+
+            for (int x = 0; x < w; x++)
+            {
+                float u = static_cast<float>(x) / static_cast<float>(w - 1);
+                float v = static_cast<float>(y) / static_cast<float>(h - 1);
+                uvs[static_cast<size_t>(y) * w + x] = glm::vec2(u, v);
+            }
+        }
+    }, rowGrain);
 }
 
 // OpenGL 관련 버퍼 초기화
-void Cloth::initGL()
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::initGL()
 {
     glGenVertexArrays(1, &vao);
     glBindVertexArray(vao);
 
+    gpuVertexCapacity = particles.size();
+
     glGenBuffers(1, &vboPos);
     glBindBuffer(GL_ARRAY_BUFFER, vboPos);
     std::vector<glm::vec3> posInit(particles.size());
     for (size_t i = 0; i < particles.size(); i++)
-        posInit[i] = particles[i].pos;
+        posInit[i] = glm::vec3(particles[i].pos);
     glBufferData(GL_ARRAY_BUFFER, posInit.size() * sizeof(glm::vec3), posInit.data(), GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
@@ -266,6 +1057,7 @@ void Cloth::initGL()
         glEnableVertexAttribArray(1);
         glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
     }
+    gpuUVCount = uvs.size();
 
     glGenBuffers(1, &vboNormal);
     glBindBuffer(GL_ARRAY_BUFFER, vboNormal);
@@ -276,21 +1068,49 @@ void Cloth::initGL()
 
     glGenBuffers(1, &ebo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_DYNAMIC_DRAW);
+    indexDirtyBegin = indexDirtyEnd = 0;
 
     glBindVertexArray(0);
 }
 
-// GPU의 VBO 데이터 업데이트
-void Cloth::updateGPU()
+// GPU의 VBO 데이터 업데이트 (찢어짐으로 바뀐 구간만 UV/EBO 재업로드)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::updateGPU()
 {
+    const size_t n = particles.size();
+
+    // 정점이 용량을 넘으면 2배로 재할당 (속성 포인터는 버퍼 이름에 묶여 있어 그대로 유효)
+    if (vboPos && n > gpuVertexCapacity)
+    {
+        gpuVertexCapacity = std::max(n, gpuVertexCapacity * 2);
+        glBindBuffer(GL_ARRAY_BUFFER, vboPos);
+        glBufferData(GL_ARRAY_BUFFER, gpuVertexCapacity * sizeof(glm::vec3), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, vboNormal);
+        glBufferData(GL_ARRAY_BUFFER, gpuVertexCapacity * sizeof(glm::vec3), nullptr, GL_DYNAMIC_DRAW);
+        if (vboUV)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, vboUV);
+            glBufferData(GL_ARRAY_BUFFER, gpuVertexCapacity * sizeof(glm::vec2), nullptr, GL_DYNAMIC_DRAW);
+            gpuUVCount = 0;
+        }
+    }
+
+    if (vboUV && gpuUVCount < uvs.size())
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, vboUV);
+        glBufferSubData(GL_ARRAY_BUFFER, gpuUVCount * sizeof(glm::vec2),
+            (uvs.size() - gpuUVCount) * sizeof(glm::vec2), uvs.data() + gpuUVCount);
+        gpuUVCount = uvs.size();
+    }
+
     if (vboPos)
     {
         glBindBuffer(GL_ARRAY_BUFFER, vboPos);
         static std::vector<glm::vec3> posBuf;
-        posBuf.resize(particles.size());
-        for (size_t i = 0; i < particles.size(); i++)
-            posBuf[i] = particles[i].pos;
+        posBuf.resize(n);
+        for (size_t i = 0; i < n; i++)
+            posBuf[i] = glm::vec3(particles[i].pos);
 
         glBufferSubData(GL_ARRAY_BUFFER, 0, posBuf.size() * sizeof(glm::vec3), posBuf.data());
     }
@@ -299,16 +1119,28 @@ void Cloth::updateGPU()
     {
         glBindBuffer(GL_ARRAY_BUFFER, vboNormal);
         static std::vector<glm::vec3> nrmBuf;
-        nrmBuf.resize(particles.size());
-        for (size_t i = 0; i < particles.size(); i++)
+        nrmBuf.resize(n);
+        for (size_t i = 0; i < n; i++)
             nrmBuf[i] = particles[i].normal;
 
         glBufferSubData(GL_ARRAY_BUFFER, 0, nrmBuf.size() * sizeof(glm::vec3), nrmBuf.data());
     }
+
+    if (ebo && indexDirtyEnd > indexDirtyBegin)
+    {
+        // EBO 바인딩은 VAO 상태이므로 VAO를 묶은 채로 갱신
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexDirtyBegin * sizeof(unsigned int),
+            (indexDirtyEnd - indexDirtyBegin) * sizeof(unsigned int), indices.data() + indexDirtyBegin);
+        glBindVertexArray(0);
+        indexDirtyBegin = indexDirtyEnd = 0;
+    }
 }
 
 // 삼각형 메시 렌더링
-void Cloth::drawTriangles()
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::drawTriangles()
 {
     glEnable(GL_DEPTH_TEST);
     glBindVertexArray(vao);
@@ -318,96 +1150,349 @@ void Cloth::drawTriangles()
     glBindVertexArray(0);
 }
 
-void Cloth::applyRadialImpulse(const glm::vec3& center, const glm::vec3& dir, float strength, float radius)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::applyRadialImpulse(const glm::vec3& center, const glm::vec3& dir, float strength, float radius)
 {
-    const float rInv = (radius > 0.f) ? 1.0f / radius : 0.f;
+    if (radius <= 0.0f || glm::dot(dir, dir) < 1e-12f) return;
 
-    for (auto& p : particles) {
-        if (p.isFixed) continue;
+    const float rInv = 1.0f / radius;
+    const Vec3 impulse(glm::normalize(dir) * strength);
 
-        float dist = glm::length(p.pos - center);
-        if (dist < radius) {
-            float falloff = 1.0f - dist * rInv;
-            glm::vec3 dv = glm::normalize(dir) * (strength * falloff);
-            p.prevPos -= dv;
-        }
+    getSpatialIndex().forEachInRadius(center, radius, [&](int i, float dist) {
+        Particle& p = particles[i];
+        if (p.isFixed) return;
+        p.prevPos -= impulse * Real(1.0f - dist * rInv);
+        markInteraction(i);
+    });
+}
+
+template<class Real, class SolveReal>
+const SpatialGrid& BasicCloth<Real, SolveReal>::getSpatialIndex()
+{
+    if (spatialVersion != positionVersion)
+    {
+        float cell = (spacing > 0.0f) ? spacing : 0.1f;
+        size_t stride = 0;
+        const glm::vec3* pos = floatPositions(stride);
+        spatial.build(pos, stride, static_cast<int>(particles.size()), cell);
+        spatialVersion = positionVersion;
     }
+    return spatial;
 }
 
-// 파티클 그리드 초기화
-void Cloth::initParticles()
+template<class Real, class SolveReal>
+int BasicCloth<Real, SolveReal>::findNearestParticle(const glm::vec3& p, float maxDist)
 {
-    particles.clear();
-    particles.reserve(numWidth * numHeight);
+    return getSpatialIndex().nearest(p, maxDist);
+}
 
-    for (int y = 0; y < numHeight; y++)
+template<class Real, class SolveReal>
+bool BasicCloth<Real, SolveReal>::raycast(const glm::vec3& origin, const glm::vec3& dir, ClothRayHit& out)
+{
+    out = ClothRayHit();
+    const int triCount = static_cast<int>(indices.size() / 3);
+    if (triCount == 0 || particles.empty()) return false;
+
+    size_t stride = 0;
+    const glm::vec3* pos = floatPositions(stride);
+    if (bvhTopologyDirty || bvh.getTriangleCount() != triCount)
     {
-        for (int x = 0; x < numWidth; x++)
-        {
-            glm::vec3 pos = glm::vec3(
-                (x - numWidth / 2.0f) * spacing,
-                -(y - numHeight / 2.0f) * spacing,
-                0.0f
-            );
+        bvh.build(pos, stride, indices.data(), triCount);
+        bvhTopologyDirty = false;
+        bvhVersion = positionVersion;
+    }
+    else if (bvhVersion != positionVersion)
+    {
+        // 찢어짐으로 정점 번호가 바뀌어도 삼각형 집합은 같으므로 refit으로 충분
+        bvh.refit(pos, stride, indices.data());
+        bvhVersion = positionVersion;
+    }
 
-            Particle p(pos);
+    TriangleBVH::Hit hit;
+    if (!bvh.raycast(pos, stride, indices.data(), origin, dir, hit)) return false;
+
+    const unsigned int* tri = &indices[static_cast<size_t>(hit.triangle) * 3];
+    out.triangle = hit.triangle;
+    out.bary = hit.bary;
+    out.t = hit.t;
+    out.point = origin + dir * hit.t;
+    int k = (hit.bary.x >= hit.bary.y && hit.bary.x >= hit.bary.z) ? 0 : (hit.bary.y >= hit.bary.z ? 1 : 2);
+    out.nearestVertex = static_cast<int>(tri[k]);
+    return true;
+}
 
-            if (y == 0 && (x == 0 || x == numWidth - 1))
+// 색인/BVH용 float 위치 (float 저장이면 파티클 배열을 보폭만 지정해 그대로 넘기고, 아니면 위치가 바뀐 뒤 한 번 변환)
+template<class Real, class SolveReal>
+const glm::vec3* BasicCloth<Real, SolveReal>::floatPositions(size_t& strideBytes)
+{
+    if constexpr (std::is_same_v<Real, float>)
+    {
+        strideBytes = sizeof(Particle);
+        return particles.empty() ? nullptr : &particles[0].pos;
+    }
+    else
+    {
+        if (positionScratchVersion != positionVersion || positionScratch.size() != particles.size())
+        {
+            positionScratch.resize(particles.size());
+            for (size_t i = 0; i < particles.size(); i++)
+                positionScratch[i] = glm::vec3(particles[i].pos);
+            positionScratchVersion = positionVersion;
+        }
+        strideBytes = sizeof(glm::vec3);
+        return positionScratch.empty() ? nullptr : positionScratch.data();
+    }
+}
+
+// 파티클 그리드 초기화 (크기를 미리 정하고 행 단위 병렬로 채움)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::initParticles()
+{
+    const int w = numWidth, h = numHeight;
+    const int y0 = gridRowOffset;
+    const int fullH = (gridFullHeight > 0) ? gridFullHeight : h;
+    particles.assign(static_cast<size_t>(w) * h, Particle(Vec3(Real(0))));
+
+    const int rowGrain = std::max(1, BasicCloth::kParallelGrain / std::max(1, w));
+    parallelFor(h, [&](int begin, int end) {
+        for (int y = begin; y < end; y++)
+        {
+            for (int x = 0; x < w; x++)
             {
-                p.isFixed = true;
+                Vec3 pos = Vec3(
+                    (x - w / 2.0f) * spacing,
+                    -(y0 + y - fullH / 2.0f) * spacing,
+                    0.0f
+                );
+
+                Particle& p = particles[getIndex(x, y)];
+                p = Particle(pos);
+                p.isFixed = (y0 + y == 0 && (x == 0 || x == w - 1));
             }
-
-            particles.push_back(p);
         }
+    }, rowGrain);
+
+    fixedCount = (h > 0 && y0 == 0) ? std::min(w, 2) : 0;
+}
+
+// 행 y가 만드는 종류 t의 스프링 수 (initSprings의 조건과 같음)
+template<class Real, class SolveReal>
+size_t BasicCloth<Real, SolveReal>::springsInRow(int y, SpringType t) const
+{
+    const int w = numWidth, h = numHeight;
+    switch (t)
+    {
+    case SpringType::Structural: return std::max(0, w - 1) + (y < h - 1 ? w : 0);
+    case SpringType::Shear:      return (y < h - 1) ? 2 * std::max(0, w - 1) : 0;
+    case SpringType::Bend:       return std::max(0, w - 2) + (y < h - 2 ? w : 0);
+    default:                     return 0;
     }
 }
 
 // 스프링 제약 조건들 초기화
-void Cloth::initSprings()
+// 종류별 구간 안에서 행별 개수로 시작 위치를 먼저 정한 뒤 행 단위 병렬로 채움 (구간 안 순서는 직렬 생성과 같음)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::initSprings()
 {
-    springs.clear();
-    springs.reserve(numWidth * numHeight * 6);
-
-    for (int y = 0; y < numHeight; y++)
+    springColorsDirty = true;
+    localAdjDirty = true;
+    solveColorsDirty = true;
+    const int w = numWidth, h = numHeight;
+    constexpr int kClasses = static_cast<int>(SpringType::Count);
+
+    std::vector<size_t> rowStart[kClasses];
+    size_t total = 0;
+    for (int c = 0; c < kClasses; c++)
     {
-        for (int x = 0; x < numWidth; x++)
+        springClassStart[c] = static_cast<int>(total);
+        rowStart[c].resize(h + 1);
+        rowStart[c][0] = total;
+        for (int y = 0; y < h; y++)
+            rowStart[c][y + 1] = rowStart[c][y] + springsInRow(y, static_cast<SpringType>(c));
+        total = rowStart[c][h];
+    }
+    springClassStart[kClasses] = static_cast<int>(total);
+    springs.assign(total, Spring(0, 0, 0.0f));
+    springRowStart.resize(static_cast<size_t>(kClasses) * (h + 1));
+    for (int c = 0; c < kClasses; c++)
+        for (int y = 0; y <= h; y++)
+            springRowStart[c * (h + 1) + y] = static_cast<int>(rowStart[c][y]);
+
+    const float diag = spacing * std::sqrt(2.0f);
+    const int rowGrain = std::max(1, BasicCloth::kParallelGrain / std::max(1, w));
+    parallelFor(h, [&](int begin, int end) {
+        for (int y = begin; y < end; y++)
         {
-            int current = getIndex(x, y);
+            Spring* structural = springs.data() + rowStart[static_cast<int>(SpringType::Structural)][y];
+            Spring* shear = springs.data() + rowStart[static_cast<int>(SpringType::Shear)][y];
+            Spring* bend = springs.data() + rowStart[static_cast<int>(SpringType::Bend)][y];
+            for (int x = 0; x < w; x++)
+            {
+                int current = getIndex(x, y);
+
+                // 가로/세로
+                if (x < w - 1)
+                    *structural++ = Spring(current, getIndex(x + 1, y), spacing);
+                if (y < h - 1)
+                    *structural++ = Spring(current, getIndex(x, y + 1), spacing);
+
+                // 대각
+                if (x < w - 1 && y < h - 1)
+                    *shear++ = Spring(current, getIndex(x + 1, y + 1), diag, SpringType::Shear);
+                if (x > 0 && y < h - 1)
+                    *shear++ = Spring(current, getIndex(x - 1, y + 1), diag, SpringType::Shear);
+
+                // 2칸
+                if (x < w - 2)
+                    *bend++ = Spring(current, getIndex(x + 2, y), spacing * 2.0f, SpringType::Bend);
+                if (y < h - 2)
+                    *bend++ = Spring(current, getIndex(x, y + 2), spacing * 2.0f, SpringType::Bend);
+            }
+        }
+    }, rowGrain);
+}
 
-            // 가로/세로
-            if (x < numWidth - 1)
-                springs.emplace_back(current, getIndex(x + 1, y), spacing);
-            if (y < numHeight - 1)
-                springs.emplace_back(current, getIndex(x, y + 1), spacing);
+// 스프링을 종류별로 묶고 (종류 안 순서 유지) 종류별 시작 위치 기록
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::groupSpringsByClass()
+{
+    constexpr int kClasses = static_cast<int>(SpringType::Count);
+    int count[kClasses] = {};
+    bool grouped = true;
+    for (size_t i = 0; i < springs.size(); i++)
+    {
+        count[static_cast<int>(springs[i].type)]++;
+        if (i > 0 && springs[i].type < springs[i - 1].type) grouped = false;
+    }
+
+    springClassStart[0] = 0;
+    for (int c = 0; c < kClasses; c++)
+        springClassStart[c + 1] = springClassStart[c] + count[c];
+    localAdjDirty = true;
+    solveColorsDirty = true;
+    if (grouped) return;
+
+    PageVector<Spring> sorted(springs.size(), Spring(0, 0, 0.0f));
+    int cursor[kClasses];
+    std::copy(springClassStart, springClassStart + kClasses, cursor);
+    for (const Spring& s : springs)
+        sorted[cursor[static_cast<int>(s.type)]++] = s;
+    springs = std::move(sorted);
+    springColorsDirty = true;
+}
+
+// 각 파티클의 노멀 벡터를 계산 (마지막 계산 이후 위치가 그대로면 생략)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::computeNormals()
+{
+    if (normalVersion == positionVersion) return;
+    normalVersion = positionVersion;
+
+    const bool pristineGrid = gridTopology && numWidth >= 2 && numHeight >= 2
+        && particles.size() == static_cast<size_t>(numWidth) * numHeight;
+    if (pristineGrid)
+        computeNormalsGrid();
+    else
+        computeNormalsMesh();
+}
+
+// 그리드 스텐실 노멀: 이웃 위치에서 한 번에 모아 계산 (행 단위 병렬, 행 내부는 x/y/z 분리 배열로 벡터화)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::computeNormalsGrid()
+{
+    parallelFor(numHeight, [&](int rowBegin, int rowEnd) {
+        computeNormalsGridRows(rowBegin, rowEnd);
+    }, std::max(1, BasicCloth::kParallelGrain / numWidth));
+}
 
-            // 대각
-            if (x < numWidth - 1 && y < numHeight - 1)
-                springs.emplace_back(current, getIndex(x + 1, y + 1), spacing * std::sqrt(2.0f));
-            if (x > 0 && y < numHeight - 1)
-                springs.emplace_back(current, getIndex(x - 1, y + 1), spacing * std::sqrt(2.0f));
+// 행 [rowBegin, rowEnd)의 그리드 노멀
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::computeNormalsGridRows(int rowBegin, int rowEnd)
+{
+    const int W = numWidth;
+    const int H = numHeight;
+    // 행 3개(위/현재/아래) + 출력 1행, 각각 x/y/z
+    thread_local std::vector<Real> scratch;
+    scratch.resize(static_cast<size_t>(W) * 12);
+    Real* rows[3] = { scratch.data(), scratch.data() + W * 3, scratch.data() + W * 6 };
+    Real* nx = scratch.data() + W * 9;
+    Real* ny = nx + W;
+    Real* nz = ny + W;
+    int loaded[3] = { -1, -1, -1 };
+
+    // 행 r의 위치를 분리 배열로 (연속한 세 행은 서로 다른 슬롯)
+    auto row = [&](int r) -> const Real* {
+        Real* dst = rows[r % 3];
+        if (loaded[r % 3] != r)
+        {
+            const Particle* p = &particles[static_cast<size_t>(r) * W];
+            for (int i = 0; i < W; i++)
+            {
+                dst[i] = p[i].pos.x;
+                dst[W + i] = p[i].pos.y;
+                dst[W * 2 + i] = p[i].pos.z;
+            }
+            loaded[r % 3] = r;
+        }
+        return dst;
+    };
 
-            // 2칸
-            if (x < numWidth - 2)
-                springs.emplace_back(current, getIndex(x + 2, y), spacing * 2.0f);
-            if (y < numHeight - 2)
-                springs.emplace_back(current, getIndex(x, y + 2), spacing * 2.0f);
+    for (int y = rowBegin; y < rowEnd; y++)
+    {
+        const Real* up = row(std::max(y - 1, 0));
+        const Real* dn = row(std::min(y + 1, H - 1));
+        const Real* cur = row(y);
+        const Real* cx = cur; const Real* cy = cur + W; const Real* cz = cur + W * 2;
+        const Real* ux = up; const Real* uy = up + W; const Real* uz = up + W * 2;
+        const Real* dx = dn; const Real* dy = dn + W; const Real* dz = dn + W * 2;
+
+        // 가장자리는 한쪽 차분
+        auto edge = [&](int i, int l, int r) {
+            Vec3 a(cx[r] - cx[l], cy[r] - cy[l], cz[r] - cz[l]);
+            Vec3 b(dx[i] - ux[i], dy[i] - uy[i], dz[i] - uz[i]);
+            Vec3 n = glm::cross(a, b);
+            n = (glm::dot(n, n) > Real(1e-12f)) ? glm::normalize(n) : Vec3(0, 0, 1);
+            nx[i] = n.x; ny[i] = n.y; nz[i] = n.z;
+        };
+        edge(0, 0, 1);
+        edge(W - 1, W - 2, W - 1);
+
+        // 내부: 중심 차분 (분기 없는 루프 -> 자동 벡터화)
+        for (int i = 1; i < W - 1; i++)
+        {
+            Real ax = cx[i + 1] - cx[i - 1], ay = cy[i + 1] - cy[i - 1], az = cz[i + 1] - cz[i - 1];
+            Real bx = dx[i] - ux[i], by = dy[i] - uy[i], bz = dz[i] - uz[i];
+            Real tx = ay * bz - az * by;
+            Real ty = az * bx - ax * bz;
+            Real tz = ax * by - ay * bx;
+            Real len2 = tx * tx + ty * ty + tz * tz;
+            bool ok = len2 > Real(1e-12f);
+            Real inv = ok ? Real(1) / std::sqrt(len2) : Real(0);
+            nx[i] = tx * inv;
+            ny[i] = ty * inv;
+            nz[i] = ok ? tz * inv : Real(1);
         }
+
+        Particle* p = &particles[static_cast<size_t>(y) * W];
+        for (int i = 0; i < W; i++)
+            p[i].normal = glm::vec3(static_cast<float>(nx[i]), static_cast<float>(ny[i]), static_cast<float>(nz[i]));
     }
 }
 
-// 각 파티클의 노멀 벡터를 계산
-void Cloth::computeNormals()
+// 일반 삼각형 메시 노멀 (면 노멀을 세 정점에 누적 후 정규화)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::computeNormalsMesh()
 {
     for (auto& p : particles) p.normal = glm::vec3(0.0f);
 
     for (size_t i = 0; i + 2 < indices.size(); i += 3)
     {
         unsigned int i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
-        const glm::vec3& p0 = particles[i0].pos;
-        const glm::vec3& p1 = particles[i1].pos;
-        const glm::vec3& p2 = particles[i2].pos;
+        const Vec3& p0 = particles[i0].pos;
+        const Vec3& p1 = particles[i1].pos;
+        const Vec3& p2 = particles[i2].pos;
 
-        glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+        glm::vec3 n(glm::cross(p1 - p0, p2 - p0));
         if (glm::dot(n, n) > 1e-12f) n = glm::normalize(n);
 
         particles[i0].normal += n;
@@ -418,10 +1503,91 @@ void Cloth::computeNormals()
         p.normal = (glm::dot(p.normal, p.normal) > 1e-12f) ? glm::normalize(p.normal) : glm::vec3(0, 0, 1);
 }
 
+// 행 [rowBegin, rowEnd)만 Verlet 통합 (중력 워밍업/감쇠 환산은 stepKernel과 같음)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::integrateRows(int rowBegin, int rowEnd, float deltaTime)
+{
+    Vec3 force(Real(0), Real(-9.8f), Real(0));
+    if (frameCount < BasicCloth::kGravityWarmupFrames)
+    {
+        force.y *= Real(static_cast<float>(frameCount) / static_cast<float>(BasicCloth::kGravityWarmupFrames));
+    }
+    const float prevDt = (lastStepDt > 0.0f) ? lastStepDt : deltaTime;
+    const Real dt2 = Real(deltaTime * deltaTime);
+    const Real carry = Real(std::pow(BasicCloth::kDamping, deltaTime / BasicCloth::kReferenceStep) * (deltaTime / prevDt));
+    Real maxStep2 = Real(0);
+    integrateRange<kFeatPins>(static_cast<size_t>(rowBegin) * numWidth, static_cast<size_t>(rowEnd) * numWidth,
+        force, carry, dt2, maxStep2);
+    lastMaxSpeed = static_cast<float>(std::sqrt(maxStep2)) / deltaTime;
+}
+
+// 출발 행이 [rowBegin, rowEnd)인 스프링을 종류별로 한 번 순회 (springRowStart 구간, 강성 포함)
+template<class Real, class SolveReal>
+typename BasicCloth<Real, SolveReal>::SolveStats BasicCloth<Real, SolveReal>::solveRows(int rowBegin, int rowEnd)
+{
+    SolveStats stats;
+    if (!fusedLayoutValid()) return stats;
+
+    constexpr int kClasses = static_cast<int>(SpringType::Count);
+    const int H = numHeight;
+    const SolveReal factor = (frameCount < BasicCloth::kGravityWarmupFrames)
+        ? BasicCloth::kCorrectionFactorWarmup
+        : BasicCloth::kCorrectionFactorStable;
+    float maxStrain = 0.0f;
+    float sumSq = 0.0f;
+    int visited = 0;
+    for (int c = 0; c < kClasses; c++)
+    {
+        const int begin = springRowStart[c * (H + 1) + rowBegin];
+        const int end = springRowStart[c * (H + 1) + rowEnd];
+        solveSpringRange<kFeatPins>(begin, end, factor * SolveReal(springStiffness[c]), maxStrain, sumSq);
+        visited += end - begin;
+    }
+    stats.maxStrain = maxStrain;
+    stats.rmsStrain = (visited == 0) ? 0.0f : std::sqrt(sumSq / static_cast<float>(visited));
+    stats.visited = visited;
+    lastSolveStats = stats;
+    return stats;
+}
+
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::finishRowsStep(float deltaTime)
+{
+    lastStepDt = deltaTime;
+    positionVersion++;
+    simTime += deltaTime;
+    frameCount++;
+}
+
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::copyRowPositions(int row, int rows, glm::vec3* out) const
+{
+    const size_t begin = static_cast<size_t>(row) * numWidth;
+    const size_t count = static_cast<size_t>(rows) * numWidth;
+    for (size_t i = 0; i < count; i++)
+        out[i] = glm::vec3(particles[begin + i].pos);
+}
+
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::setRowPositions(int row, int rows, const glm::vec3* in)
+{
+    const size_t begin = static_cast<size_t>(row) * numWidth;
+    const size_t count = static_cast<size_t>(rows) * numWidth;
+    for (size_t i = 0; i < count; i++)
+        particles[begin + i].pos = Vec3(in[i]);
+    positionVersion++;
+}
+
 // 특정 파티클의 위치를 설정
-void Cloth::setParticlePos(int idx, const glm::vec3& p, bool movePrev)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::setParticlePos(int idx, const glm::vec3& p, bool movePrev)
 {
     if (idx < 0 || idx >= (int)particles.size()) return;
-    particles[idx].pos = p;
-    if (movePrev) particles[idx].prevPos = p;
-}
\ No newline at end of file
+    particles[idx].pos = Vec3(p);
+    if (movePrev) particles[idx].prevPos = particles[idx].pos;
+    positionVersion++;
+}
+
+#define CLOTH_INSTANTIATE(R, S) template class BasicCloth<R, S>;
+CLOTH_PRECISIONS(CLOTH_INSTANTIATE)
+#undef CLOTH_INSTANTIATE
@@ -2,27 +2,40 @@
 
 #include <vector>
 #include <string>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
 #include <glm/glm.hpp>
 #include <glad/glad.h>
+#include "SpatialGrid.h"
+#include "TriangleBVH.h"
+#include "ClothPlugin.h"
+#include "PageAllocator.h"
 
-// 파티클 구조체
-struct Particle
+class WindField;
+
+// 파티클 구조체 (Real: 위치 저장 정밀도, 노멀은 렌더링용이라 항상 float)
+template<class Real>
+struct BasicParticle
 {
-    glm::vec3 pos;
-    glm::vec3 prevPos;
-    glm::vec3 acceleration;
-    glm::vec3 restPos;
+    using Vec3 = glm::vec<3, Real>;
+
+    Vec3 pos;
+    Vec3 prevPos;
+    Vec3 acceleration;
+    Vec3 restPos;
     bool isFixed = false;
     glm::vec2 uv;
 
     glm::vec3 normal = glm::vec3(0.0f);
 
-    Particle(const glm::vec3& p)
-        : pos(p), prevPos(p), restPos(p), acceleration(0.0f) {
+    BasicParticle(const Vec3& p)
+        : pos(p), prevPos(p), restPos(p), acceleration(Real(0)) {
     }
 
     // 파티클에 힘을 적용합니다.
-    void applyForce(const glm::vec3& force)
+    void applyForce(const Vec3& force)
     {
         if (!isFixed)
             acceleration += force;
@@ -34,55 +47,305 @@ struct Particle
         if (isFixed)
             return;
 
-        glm::vec3 vel = (pos - prevPos) * damping;
-        glm::vec3 next = pos + vel + acceleration * deltaTime * deltaTime;
+        Vec3 vel = (pos - prevPos) * Real(damping);
+        Vec3 next = pos + vel + acceleration * Real(deltaTime * deltaTime);
 
         prevPos = pos;
         pos = next;
-        acceleration = glm::vec3(0.0f);
+        acceleration = Vec3(Real(0));
     }
 };
 
+using Particle = BasicParticle<float>;
+
+// 스프링 종류 (구조/전단/굽힘)
+enum class SpringType : unsigned char
+{
+    Structural = 0,
+    Shear,
+    Bend,
+    Count
+};
+
 // 스프링 구조체
 struct Spring
 {
     int p1, p2;
     float restLength;
+    SpringType type;
+
+    Spring(int i1, int i2, float length, SpringType t = SpringType::Structural)
+        : p1(i1), p2(i2), restLength(length), type(t)
+    {
+    }
+};
+
+// 바람(공기역학) 파라미터: 삼각형별 항력/양력
+struct WindParams
+{
+    glm::vec3 velocity = glm::vec3(0.0f); // 바람 속도 (m/s)
+    float dragCoeff = 1.0f;               // 항력 계수 Cd
+    float liftCoeff = 0.5f;               // 양력 계수 Cl
+    float airDensity = 1.2f;              // 공기 밀도 (kg/m^3)
+    float arealDensity = 0.15f;           // 천 면밀도 (kg/m^2), 정점 질량 = 면밀도 * spacing^2
+};
+
+// 적응 시간 간격 파라미터 (Cloth::advance)
+struct TimeStepParams
+{
+    float cflNumber = 0.5f;          // 한 서브스텝에 허용할 최대 이동량 (spacing 배수)
+    float strainGrowthLimit = 0.05f; // 한 스텝에 최대 변형률이 이보다 많이 늘면 간격을 절반으로
+    float minStep = 1.0f / 600.0f;
+    float maxStep = 1.0f / 60.0f;
+    int   maxSubsteps = 8;           // 프레임당 계산 예산 (넘는 시간은 버려서 느려질지언정 폭주하지 않음)
+};
+
+// 상호작용 지점 주변 국소 반복 (Cloth::setLocalSolve)
+// 드래그/충격/핀 변경이 닿은 파티클에서 스프링 그래프로 hops 단계 안의 스프링만 골라
+// 전역 반복 전에 iterations번 더 순회하고, 그 지점을 holdSteps 스텝 동안 유지 (iterations가 0이면 비활성)
+struct LocalSolveParams
+{
+    int iterations = 4;
+    int hops = 4;
+    int holdSteps = 12;
+};
+
+// 충돌체 (평면/구)
+struct Collider
+{
+    enum class Type { Plane, Sphere };
+
+    Type type = Type::Plane;
+    glm::vec3 center = glm::vec3(0.0f); // 구 중심 또는 평면 위의 한 점
+    glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);
+    float radius = 0.0f;
+
+    static Collider plane(const glm::vec3& point, const glm::vec3& n)
+    {
+        Collider c;
+        c.type = Type::Plane;
+        c.center = point;
+        c.normal = glm::normalize(n);
+        return c;
+    }
 
-    Spring(int i1, int i2, float length)
-        : p1(i1), p2(i2), restLength(length)
+    static Collider sphere(const glm::vec3& c0, float r)
     {
+        Collider c;
+        c.type = Type::Sphere;
+        c.center = c0;
+        c.radius = r;
+        return c;
     }
 };
 
-class Cloth
+// 광선 피킹 결과 (천 로컬 공간)
+struct ClothRayHit
+{
+    int triangle = -1;      // indices 기준 삼각형 번호
+    glm::vec3 bary{ 0.0f }; // 삼각형 세 정점에 대한 무게중심 좌표
+    glm::vec3 point{ 0.0f };
+    float t = 0.0f;
+    int nearestVertex = -1; // 무게중심 좌표가 가장 큰 정점
+};
+
+// 정밀도 조합 목록 (멤버 정의가 여러 .cpp에 나뉘어 있어 파일마다 이 목록으로 명시적 인스턴스화)
+#define CLOTH_PRECISIONS(X) X(float, float) X(double, double) X(double, float)
+
+// 천 시뮬레이터
+// Real: 위치/이전 위치 저장 정밀도, SolveReal: 스프링 제약/변형률 계산 정밀도
+// 혼합 모드(double, float)는 위치를 double로 들고 차이 벡터만 float로 바꿔 제약을 풀어 원점에서 먼 장면도 흔들리지 않음
+// 공개 API, 공간 색인/BVH, GPU 업로드는 정밀도와 상관없이 float glm::vec3
+template<class Real, class SolveReal = Real>
+class BasicCloth
 {
 public:
-    Cloth(int width, int height, float spacing);
-    ~Cloth();
+    using Particle = BasicParticle<Real>;
+    using Vec3 = glm::vec<3, Real>;
+
+    BasicCloth(int width, int height, float spacing);
+    // 더 큰 격자(fullHeight행)의 행 [rowOffset, rowOffset + height)만 만듦 (띠 분할용)
+    // 위치와 고정점은 전체 격자 기준이고, 창 아래로 벗어나는 스프링은 만들지 않음
+    BasicCloth(int width, int height, float spacing, int rowOffset, int fullHeight);
+    ~BasicCloth();
     void destroyGL();
 
+    // 임의 삼각형 메시(OBJ 패널)로 천을 다시 구성
+    bool loadFromOBJ(const std::string& path);
+    bool isGrid() const { return gridTopology; }
+
+    // 격자 해상도 변경 (현재 변형 상태와 핀을 새 격자로 옮김, 메시/찢어진 천이면 false)
+    bool resampleGrid(int newWidth, int newHeight);
+
     // 앵커(고정점) 인덱스 접근자
-    int leftAnchorIndex() const { return getIndex(0, 0); }
-    int rightAnchorIndex() const { return getIndex(numWidth - 1, 0); }
+    int leftAnchorIndex() const { return corners[0]; }
+    int rightAnchorIndex() const { return corners[1]; }
 
-    // 파티클 위치 설정
+    // 코너 인덱스 (TL, TR, BL, BR)
+    const std::array<int, 4>& getCornerIndices() const { return corners; }
+
+    // 파티클 위치 설정/조회 (float)
     void setParticlePos(int idx, const glm::vec3& p, bool movePrev = true);
+    glm::vec3 getParticlePos(int idx) const { return glm::vec3(particles[idx].pos); }
 
     // 시뮬레이션 상수
     static const float kDamping;
-    static const int   kConstraintIters;
+    static const int   kConstraintIters;    // 잔차가 보통일 때의 반복 수
+    static const int   kMinConstraintIters; // 허용 오차 안이어도 최소 반복 수
+    static const int   kMaxConstraintIters; // 잔차가 클 때 상한
+    static const float kResidualHigh;       // kConstraintIters에서 순회당 잔차가 이보다 크면 추가 반복
+    static const float kReferenceStep;      // kDamping이 정의된 스텝 길이
     static const float kCorrectionFactorStable;
     static const float kCorrectionFactorWarmup;
     static const int   kGravityWarmupFrames;
-    static const float kWindStrength;
-    static const glm::vec3 kWindDir;
+    static const float kCollisionMargin;
+    static const int   kParallelGrain;   // 병렬 구간당 최소 파티클 수
+    static const int   kPluginBatch;     // 플러그인 호출당 파티클 수
+    static const float kContactRequery;  // 이만큼(spacing 배수) 움직인 파티클만 충돌체를 다시 질의
+    static const float kContactSlack;    // 표면에서 이 거리(spacing 배수) 안이면 접촉 유지
+    static const int   kMaxCachedColliders;
+    static const int   kFusedBlockParticles; // 융합 파이프라인에서 한 번에 통합/순회하는 행 블록 크기 (파티클 수)
+
+    // 스텝 커널 특성 플래그 (조합마다 커널이 미리 인스턴스화됨)
+    enum StepFeature : unsigned
+    {
+        kFeatPins = 1u << 0,
+        kFeatWind = 1u << 1,
+        kFeatColliders = 1u << 2,
+        kFeatSpringTypes = 1u << 3,
+        kFeatWarmup = 1u << 4,
+        kFeatCombinations = 1u << 5
+    };
+    unsigned currentFeatures() const;
 
     // 시뮬레이션
     void update(float deltaTime);
+
+    // 프레임 시간을 CFL(속도/spacing)과 변형률 증가로 정한 서브스텝으로 나눠 진행
+    void advance(float frameTime);
+    // 남은 시간 중 다음 서브스텝 길이 (여러 천을 같은 간격으로 맞춰 돌릴 때)
+    float nextStepSize(float remaining) const;
+    void setTimeStep(const TimeStepParams& t) { timeStep = t; }
+    const TimeStepParams& getTimeStep() const { return timeStep; }
+    int getLastSubsteps() const { return lastSubsteps; }
+    float getLastStepSize() const { return lastStepDt; }
+    // 입자당 평균 운동 에너지 (단위 질량, 직전 스텝의 pos - prevPos로 잰 속도)
+    float getKineticEnergy() const;
+    // 모든 입자 속도에 keep을 곱함 (0이면 정지, 위치는 그대로)
+    void scaleVelocities(float keep)
+    {
+        for (auto& p : particles)
+            p.prevPos = p.pos - (p.pos - p.prevPos) * Real(keep);
+    }
     void applyGravity(const glm::vec3& gravity);
     void satisfyConstraints();
 
+    // 스프링 잔차 (상대 변형률 |L - L0| / L0, 반복 직전 측정)
+    struct SolveStats
+    {
+        float maxStrain = 0.0f;
+        float rmsStrain = 0.0f;
+        int visited = 0;        // 이번 순회에서 본 스프링 수
+    };
+
+    // 적응 반복: 순회당 잔차(직전 순회가 바꾼 변형률 / 이번 스텝 첫 순회 변형률)가 허용 오차 아래면
+    // kMinConstraintIters부터 조기 종료, kConstraintIters에서도 kResidualHigh보다 크면 kMaxConstraintIters까지 추가 반복
+    void setSolverTolerance(float tol) { solverTolerance = tol; }
+    float getSolverTolerance() const { return solverTolerance; }
+    int getLastIterationCount() const { return lastIterations; }
+
+    // 품질 조절 (프레임 예산용): 스텝당 제약 반복 상한 (0이면 kMaxConstraintIters), 노멀을 이 스텝 수마다 갱신
+    void setIterationCap(int cap) { iterationCap = cap; }
+    int getIterationCap() const { return iterationCap; }
+    void setNormalInterval(int steps) { normalInterval = std::max(1, steps); }
+    int getNormalInterval() const { return normalInterval; }
+    const SolveStats& getLastSolveStats() const { return lastSolveStats; }
+
+    // 띠 분할용 스텝 (격자 전용): 바깥에서 할로 교환을 사이에 끼워 넣으며
+    // integrateRows -> solveRows 반복 -> finishRowsStep 순으로 부름 (바람/충돌체/훅은 쓰지 않음)
+    void integrateRows(int rowBegin, int rowEnd, float deltaTime);
+    SolveStats solveRows(int rowBegin, int rowEnd);
+    void finishRowsStep(float deltaTime);
+    // 행 [row, row + rows) 위치 복사 (이전 위치는 그대로)
+    void copyRowPositions(int row, int rows, glm::vec3* out) const;
+    void setRowPositions(int row, int rows, const glm::vec3* in);
+
+    // 바람 (실행 중 수정 가능)
+    void setWind(const WindParams& w) { wind = w; }
+    const WindParams& getWind() const { return wind; }
+
+    // 난류 바람장 (상대풍에 더해짐, nullptr이면 비활성)
+    void setWindField(WindField* field) { windField = field; }
+    float getSimTime() const { return simTime; }
+
+    // 외부 힘/제약 플러그인 (소유하지 않음)
+    // 힘은 바람 다음, 적분 전에 가속도로 더해지고 제약 훅은 스프링 제약/변형률 제한 뒤에 실행
+    void addForceField(ForceField* f) { forceFields.push_back(f); }
+    void removeForceField(ForceField* f) { std::erase(forceFields, f); }
+    void addConstraintHook(ConstraintHook* h) { constraintHooks.push_back(h); }
+    void removeConstraintHook(ConstraintHook* h) { std::erase(constraintHooks, h); }
+
+    // 충돌체
+    void addCollider(const Collider& c) { colliders.push_back(c); colliderVersion++; }
+    void clearColliders() { colliders.clear(); colliderVersion++; }
+    const std::vector<Collider>& getColliders() const { return colliders; }
+
+    // 충돌체 접촉 캐시 (접촉 수, 이번 스텝에 충돌체를 다시 질의한 파티클 수)
+    struct ContactStats
+    {
+        int contacts = 0;
+        int requeried = 0;
+    };
+    const ContactStats& getLastContactStats() const { return lastContactStats; }
+
+    // 찢어짐: 변형률이 임계값을 넘는 스프링을 끊고 끊긴 에지를 따라 정점 분리 (0이면 비활성)
+    void setTearStrain(float strain) { tearStrain = strain; }
+    float getTearStrain() const { return tearStrain; }
+    int getTornVertexCount() const { return tearTopologyReady ? static_cast<int>(particles.size() - restParticleCount) : 0; }
+
+    // 변형률 제한: 제약 반복 뒤 스프링 길이를 종류별로 [1-e, 1+e] * restLength로 한 번 자름 (0이면 해당 종류 비활성)
+    void setStrainLimit(SpringType t, float eps) { strainLimit[static_cast<int>(t)] = eps; }
+    float getStrainLimit(SpringType t) const { return strainLimit[static_cast<int>(t)]; }
+
+    // 스프링 종류별 강성 배율 (모두 1이면 단일 계수 커널 사용)
+    void setSpringStiffness(SpringType t, float k) { springStiffness[static_cast<int>(t)] = k; }
+    float getSpringStiffness(SpringType t) const { return springStiffness[static_cast<int>(t)]; }
+
+    // 스프링 종류별 일정 (스프링은 종류별로 묶여 저장되고 종류마다 따로 순회)
+    // iterations: 스텝당 반복 상한 (0이면 적응 반복을 끝까지 따름), interval: 이 스텝 수마다 한 번만 순회
+    struct SpringSchedule
+    {
+        int iterations = 0;
+        int interval = 1;
+    };
+    void setSpringSchedule(SpringType t, const SpringSchedule& s) { springSchedule[static_cast<int>(t)] = s; }
+    const SpringSchedule& getSpringSchedule(SpringType t) const { return springSchedule[static_cast<int>(t)]; }
+    int getSpringClassCount(SpringType t) const
+    {
+        return springClassStart[static_cast<int>(t) + 1] - springClassStart[static_cast<int>(t)];
+    }
+    // 마지막 스텝에서 모든 반복을 합쳐 순회한 스프링 수 (국소 반복 포함)
+    long long getLastSpringVisits() const { return lastSpringVisits; }
+
+    // 상호작용 지점 주변 국소 반복
+    void setLocalSolve(const LocalSolveParams& p) { localSolve = p; }
+    const LocalSolveParams& getLocalSolve() const { return localSolve; }
+    int getLastLocalSprings() const { return lastLocalSprings; }
+
+    // 융합 파이프라인 (격자 천): 행 블록마다 통합 직후 첫 순회를 이어서 하고, 노멀은 마지막 순회에 합침
+    // 마지막 순회를 미리 알아야 하므로 적응 반복 대신 iterations번 고정 (노멀은 충돌/훅/변형률 제한이 없을 때만 합침)
+    void setFusedPipeline(bool on, int iterations) { fusedPipeline = on; fusedIterations = iterations; }
+    bool isFusedPipeline() const { return fusedPipeline; }
+    int getFusedIterations() const { return fusedIterations; }
+    bool isFusedPipelineActive() const { return fusedPipeline && !parallelSolve && fusedLayoutValid(); }
+
+    // 색칠 병렬 순회: 끝점을 공유하지 않는 스프링 묶음(종류별 색)마다 parallelFor, 통합도 병렬
+    // 순회 순서가 바뀌어 결과가 직렬 경로와 조금 달라지므로 처리량이 중요할 때만 (정착 모드), 켜면 융합 파이프라인은 쉼
+    void setParallelSolve(bool enabled) { parallelSolve = enabled; }
+    bool isParallelSolve() const { return parallelSolve; }
+    // 파티클을 상호작용 지점으로 표시 (드래그 중이면 매 프레임 호출, 핀 변경/충격은 자동)
+    void markInteraction(int particle);
+
     // 렌더링
     void draw();
 
@@ -96,9 +359,29 @@ public:
     bool exportOBJ(const std::string& objPath, const std::string& mtlName, const char* texPath, float uvScale = 1.0f);
 
     // 접근자
-    const std::vector<Particle>& getParticles() const { return particles; }
+    const PageVector<Particle>& getParticles() const { return particles; }
+    const PageVector<Spring>& getSprings() const { return springs; }
+
+    // 생성자에서 격자 토폴로지를 만드는 데 걸린 시간
+    struct TopologyBuildStats
+    {
+        float particlesMs = 0.0f;
+        float springsMs = 0.0f;
+        float indicesMs = 0.0f;
+        float totalMs() const { return particlesMs + springsMs + indicesMs; }
+    };
+    const TopologyBuildStats& getTopologyBuildStats() const { return topologyStats; }
+
+    // 큰 버퍼의 실제 배치 (대용량 페이지 비율, NUMA 노드별 표본 수)
+    struct BufferPlacement
+    {
+        const char* name;
+        PagePlacement placement;
+    };
+    std::vector<BufferPlacement> queryBufferPlacement() const;
     int getWidth() const { return numWidth; }
     int getHeight() const { return numHeight; }
+    float getSpacing() const { return spacing; }
 
     // 노멀 계산
     void computeNormals();
@@ -111,6 +394,12 @@ public:
     void setParticleFixed(int idx, bool fixed)
     {
         if (idx < 0 || idx >= (int)particles.size()) return;
+        if (particles[idx].isFixed != fixed)
+        {
+            fixedCount += fixed ? 1 : -1;
+            springColorsDirty = true;
+            markInteraction(idx);
+        }
         particles[idx].isFixed = fixed;
         if (fixed) particles[idx].prevPos = particles[idx].pos;
     }
@@ -122,44 +411,96 @@ public:
     {
         for (auto& p : particles)
             p.isFixed = false;
+        fixedCount = 0;
+        springColorsDirty = true;
     }
     void resetToRest()
     {
+        if (tearTopologyReady)
+            restoreTopology();
         for (auto& p : particles)
         {
             p.pos = p.prevPos = p.restPos;
-            p.acceleration = glm::vec3(0.0f);
+            p.acceleration = Vec3(Real(0));
         }
+        positionVersion++;
+        lastSolveStats = SolveStats();
+        lastStepDt = lastMaxSpeed = lastStrainGrowth = 0.0f;
         resetInitialFixed();
     }
     void resetInitialFixed()
     {
-        for (auto& p : particles)
-            p.isFixed = false;
-
-        int L = 0;
-        particles[L].isFixed = true;
-
-        int R = getWidth() - 1;
-        particles[R].isFixed = true;
+        clearAllFixed();
+        for (int idx : pinAnchors)
+            setParticleFixed(idx, true);
     }
 
     void applyRadialImpulse(const glm::vec3& center,
         const glm::vec3& dir,
         float strength, float radius);
 
+    // 공간 색인 (위치가 바뀐 뒤 처음 질의할 때 한 번만 재구성)
+    // 피킹/임펄스/브러시 도구가 공유
+    const SpatialGrid& getSpatialIndex();
+    int findNearestParticle(const glm::vec3& p, float maxDist = 1e30f);
+
+    // 천 사이 충돌 등 외부 질의용 float 위치 (strideBytes 간격, float 저장이면 복사 없음)
+    const glm::vec3* floatPositions(size_t& strideBytes);
+    const PageVector<unsigned int>& getIndices() const { return indices; }
+
+    // 외부 보정으로 파티클을 옮김 (고정점은 무시)
+    void displaceParticle(int idx, const glm::vec3& delta)
+    {
+        if (idx < 0 || idx >= (int)particles.size() || particles[idx].isFixed) return;
+        particles[idx].pos += Vec3(delta);
+        positionVersion++;
+    }
+
+    // 천 전체를 평행 이동 (휴지 위치 포함, 여러 천을 배치할 때)
+    void translate(const glm::vec3& offset)
+    {
+        const Vec3 d(offset);
+        for (auto& p : particles)
+        {
+            p.pos += d;
+            p.prevPos += d;
+            p.restPos += d;
+        }
+        positionVersion++;
+    }
+
+    // 현재 변형된 메시에 대한 광선 교차 (BVH는 토폴로지가 바뀔 때만 재구성, 그 외엔 refit)
+    bool raycast(const glm::vec3& origin, const glm::vec3& dir, ClothRayHit& out);
+
 private:
-    // 그리드 정보
+    // 그리드 정보 (메시 천이면 spacing은 평균 에지 길이)
     int numWidth;
     int numHeight;
     float spacing;
+    int gridRowOffset = 0;   // 띠 분할: 전체 격자에서 첫 행 번호
+    int gridFullHeight = 0;  // 띠 분할: 전체 격자 행 수 (0이면 numHeight)
+    bool gridTopology = true;
+    std::array<int, 4> corners = { 0, 0, 0, 0 };
+    std::vector<int> pinAnchors;
 
     // 데이터
-    std::vector<Particle> particles;
-    std::vector<Spring>   springs;
+    PageVector<Particle> particles;
+    PageVector<Spring>   springs;
+    std::vector<Collider> colliders;
+    WindParams wind;
+    WindField* windField = nullptr;
+    std::vector<ForceField*> forceFields;
+    std::vector<ConstraintHook*> constraintHooks;
+    float springStiffness[static_cast<int>(SpringType::Count)] = { 1.0f, 1.0f, 1.0f };
+    SpringSchedule springSchedule[static_cast<int>(SpringType::Count)] = { { 0, 1 }, { 0, 1 }, { 0, 1 } };
+    int springClassStart[static_cast<int>(SpringType::Count) + 1] = {}; // springs에서 종류별 시작 위치
+    std::vector<int> springRowStart; // 격자: 종류 c의 행 y 스프링 시작 = [c * (numHeight + 1) + y]
+    long long lastSpringVisits = 0;
+    int fixedCount = 0;
+    TopologyBuildStats topologyStats;
 
     // 메시 (인덱스/UV)
-    std::vector<unsigned int> indices;
+    PageVector<unsigned int>  indices;
     std::vector<glm::vec2>    uvs;
     int gridW = 0;
     int gridH = 0;
@@ -171,11 +512,155 @@ private:
     unsigned int vboUV = 0;
     unsigned int vboNormal = 0;
 
+    // GPU 부분 업로드 상태 (정점 버퍼 용량, 올라간 UV 개수, 변경된 인덱스 범위)
+    size_t gpuVertexCapacity = 0;
+    size_t gpuUVCount = 0;
+    size_t indexDirtyBegin = 0;
+    size_t indexDirtyEnd = 0;
+
+    // 찢어짐 토폴로지 (처음 활성화될 때 구성)
+    float tearStrain = 0.0f;
+    bool tearTopologyReady = false;
+    std::vector<std::vector<int>> vertexTris;
+    std::vector<std::vector<int>> vertexSprings;
+    std::unordered_map<std::uint64_t, int> edgeSpringCount;
+    size_t restParticleCount = 0;
+    PageVector<Spring> restSprings;
+    PageVector<unsigned int> restIndices;
+
+    // 변형률 제한 (정점을 공유하지 않는 스프링끼리 색을 나눠 색별로 병렬 처리)
+    std::array<float, 3> strainLimit = { 0.0f, 0.0f, 0.0f };
+    bool springColorsDirty = true;
+    // 핀에서 먼 순서(BFS 깊이)로 묶어, 핀 쪽 끝점은 고정하고 먼 쪽만 당겨 한 번에 사슬 전체가 펴지게 함
+    std::vector<int> springColorOrder;
+    std::vector<unsigned char> springLimitSide; // 0: 양쪽 이동, 1: p1만, 2: p2만
+    std::vector<int> springColorStart;          // 묶음 경계
+    std::vector<unsigned char> springBatchSerial; // 색이 모자라 직렬로 도는 묶음
+
+    // 색칠 병렬 순회 (종류별로 양 끝점을 공유하지 않게 색칠, 토폴로지가 바뀌면 다시 만듦)
+    bool parallelSolve = false;
+    bool solveColorsDirty = true;
+    std::vector<int> solveColorOrder;               // 종류 -> 색 순으로 묶은 스프링 번호
+    std::vector<int> solveColorStart;               // 묶음 경계
+    std::vector<unsigned char> solveBatchSerial;    // 색이 모자라 직렬로 도는 묶음
+    int solveClassBatch[static_cast<int>(SpringType::Count) + 1] = {}; // 종류 c의 묶음 구간
+
+    // 충돌체 접촉 캐시 (파티클, 충돌체 번호)
+    struct ColliderContact
+    {
+        int particle;
+        int collider;
+    };
+    unsigned long long colliderVersion = 0;
+    unsigned long long contactColliderVersion = 0;
+    std::vector<Vec3> contactQueryPos;        // 마지막으로 충돌체를 질의한 위치
+    std::vector<std::uint64_t> contactNear;   // 그때 가까웠던 충돌체 비트
+    std::vector<ColliderContact> cachedContacts;
+    ContactStats lastContactStats;
+
+    // 국소 반복 (씨앗 = 상호작용이 닿은 파티클과 남은 스텝 수)
+    struct LocalSeed
+    {
+        int particle;
+        int stepsLeft;
+    };
+    LocalSolveParams localSolve;
+    std::vector<LocalSeed> localSeeds;
+    std::vector<int> localAdjStart, localAdj; // 정점 -> 스프링 CSR
+    bool localAdjDirty = true;
+    std::vector<unsigned> localParticleMark, localSpringMark;
+    unsigned localStamp = 0;
+    std::vector<int> localSprings, localFrontier, localNext;
+    int lastLocalSprings = 0;
+
+    // 적응 반복 상태
+    float solverTolerance = 3e-3f;
+    int iterationCap = 0;
+    int normalInterval = 1;
+    bool fusedPipeline = false;
+    int fusedIterations = 8;
+    int lastIterations = 0;
+    SolveStats lastSolveStats;
+
+    // 적응 시간 간격 상태 (속도/변형률 증가는 stepKernel에서 같이 측정)
+    TimeStepParams timeStep;
+    float lastStepDt = 0.0f;
+    float lastMaxSpeed = 0.0f;
+    float lastStrainGrowth = 0.0f;
+    int lastSubsteps = 0;
+
     // 시뮬레이션 상태
     int frameCount = 0;
+    float simTime = 0.0f;
+
+    // 위치가 바뀔 때마다 증가, 노멀은 마지막으로 계산한 버전을 기억
+    unsigned long long positionVersion = 1;
+    unsigned long long normalVersion = 0;
+    unsigned long long spatialVersion = 0;
+    SpatialGrid spatial;
+    TriangleBVH bvh;
+    std::vector<glm::vec3> positionScratch; // float가 아닐 때 색인/BVH에 넘기는 위치 사본
+    unsigned long long positionScratchVersion = 0;
+    unsigned long long bvhVersion = 0;
+    bool bvhTopologyDirty = true;
+
+    // 특성 조합별 스텝 커널
+    using StepFn = void (BasicCloth::*)(float);
+    using SolveFn = SolveStats (BasicCloth::*)(unsigned);
+    template<unsigned Features> void stepKernel(float deltaTime);
+    template<unsigned Features> SolveStats solveKernel(unsigned classMask);
+    template<unsigned Features> void solveSpring(const Spring& s, SolveReal k, float& maxStrain, float& sumSq);
+    template<unsigned Features> void solveSpringRange(int begin, int end, SolveReal k, float& maxStrain, float& sumSq);
+    template<unsigned Features> void solveClassColored(int c, SolveReal k, float& maxStrain, float& sumSq);
+    void buildSolveColors();
+    template<unsigned Features> void integrateRange(size_t begin, size_t end, const Vec3& force, Real carry, Real dt2, Real& maxStep2);
+    template<unsigned Features> SolveStats fusedSweep(unsigned classMask, bool integrate, bool normals,
+        const Vec3& force, Real carry, Real dt2, Real& maxStep2);
+    bool fusedLayoutValid() const;
+    template<bool HasPins> void resolveCollisions();
+    bool projectContact(Particle& p, const Collider& c, Real slack);
+    std::uint64_t queryNearColliders(const Vec3& pos, Real range) const;
+    void projectCachedContacts();
+    void accumulateAerodynamics(float deltaTime);
+    void runForceFields(float dt);
+    void runConstraintHooks(float dt);
+    void buildSpringColors();
+    void limitStrain();
+    int solveLocal();
+    template<std::size_t... I>
+    static constexpr std::array<StepFn, sizeof...(I)> makeStepTable(std::index_sequence<I...>);
+    template<std::size_t... I>
+    static constexpr std::array<SolveFn, sizeof...(I)> makeSolveTable(std::index_sequence<I...>);
+
+    // 찢어짐 처리
+    void buildTearTopology();
+    void processTears();
+    void removeSpring(int si);
+    void splitVertex(int v);
+    void restoreTopology();
+    void markIndicesDirty(size_t begin, size_t end);
 
     // 유틸리티
+    static std::uint64_t edgeKey(unsigned int a, unsigned int b)
+    {
+        if (a > b) std::swap(a, b);
+        return (static_cast<std::uint64_t>(a) << 32) | b;
+    }
     int getIndex(int x, int y) const { return y * numWidth + x; }
     void initParticles();
     void initSprings();
-};
\ No newline at end of file
+    size_t springsInRow(int y, SpringType t) const;
+    void groupSpringsByClass();
+    void reorderHilbert();
+    void computeNormalsGrid();
+    void computeNormalsGridRows(int rowBegin, int rowEnd);
+    void computeNormalsMesh();
+};
+
+using Cloth = BasicCloth<float>;
+using ClothDouble = BasicCloth<double>;
+using ClothMixed = BasicCloth<double, float>;
+
+#define CLOTH_EXTERN_TEMPLATE(R, S) extern template class BasicCloth<R, S>;
+CLOTH_PRECISIONS(CLOTH_EXTERN_TEMPLATE)
+#undef CLOTH_EXTERN_TEMPLATE
@@ -0,0 +1,208 @@
+﻿#include "ClothBatch.h"
+#include "Cloth.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+// Cloth 하나를 간격 1로 만들어 스프링/고정점 토폴로지를 그대로 가져옴
+template<int Lanes>
+BasicClothBatch<Lanes>::BasicClothBatch(int width, int height, const std::vector<InstanceParams>& instances)
+    : numWidth(width), numHeight(height), numParticles(width * height),
+    numBlocks(static_cast<int>((instances.size() + Lanes - 1) / Lanes)),
+    iterations(Cloth::kConstraintIters), params(instances)
+{
+    const Cloth topology(width, height, 1.0f);
+    springs.reserve(topology.getSprings().size());
+    for (const Spring& s : topology.getSprings())
+        springs.push_back({ s.p1, s.p2, s.restLength });
+    fixed.reserve(numParticles);
+    for (const auto& p : topology.getParticles())
+        fixed.push_back(p.isFixed ? 1 : 0);
+
+    // 빈 레인은 마지막 인스턴스를 복제해 채움 (결과는 버림)
+    laneParams.resize(numBlocks);
+    pos.resize(static_cast<size_t>(numBlocks) * numParticles);
+    for (int b = 0; b < numBlocks; b++)
+    {
+        for (int l = 0; l < Lanes; l++)
+        {
+            const InstanceParams& ip = params[std::min(b * Lanes + l, static_cast<int>(params.size()) - 1)];
+            laneParams[b].spacing[l] = ip.spacing;
+            laneParams[b].damping[l] = ip.damping;
+            laneParams[b].factor[l] = ip.correctionFactor;
+
+            for (int k = 0; k < numParticles; k++)
+            {
+                const glm::vec3 rest = topology.getParticlePos(k) * ip.spacing;
+                LaneVec3& v = pos[static_cast<size_t>(b) * numParticles + k];
+                v.x[l] = rest.x;
+                v.y[l] = rest.y;
+                v.z[l] = rest.z;
+            }
+        }
+    }
+    prevPos = pos;
+}
+
+template<int Lanes>
+glm::vec3 BasicClothBatch<Lanes>::getParticlePos(int instance, int idx) const
+{
+    const LaneVec3& v = pos[static_cast<size_t>(instance / Lanes) * numParticles + idx];
+    const int l = instance % Lanes;
+    return glm::vec3(v.x[l], v.y[l], v.z[l]);
+}
+
+// 묶음마다 독립이라 묶음 단위로 병렬
+template<int Lanes>
+void BasicClothBatch<Lanes>::step(float deltaTime)
+{
+    const float prevDt = (lastStepDt > 0.0f) ? lastStepDt : deltaTime;
+    const bool warmup = frameCount < Cloth::kGravityWarmupFrames;
+    parallelFor(numBlocks, [&](int begin, int end) {
+        for (int b = begin; b < end; b++)
+            stepBlock(b, deltaTime, prevDt, warmup);
+    }, 1);
+    lastStepDt = deltaTime;
+    frameCount++;
+}
+
+// 레인 루프는 분기 없이 작성 (레인 수만큼 자동 벡터화)
+template<int Lanes>
+void BasicClothBatch<Lanes>::stepBlock(int block, float deltaTime, float prevDt, bool warmup)
+{
+    const LaneParams& lp = laneParams[block];
+    LaneVec3* P = pos.data() + static_cast<size_t>(block) * numParticles;
+    LaneVec3* Q = prevPos.data() + static_cast<size_t>(block) * numParticles;
+
+    float gravity = -9.8f;
+    if (warmup)
+        gravity *= static_cast<float>(frameCount) / static_cast<float>(Cloth::kGravityWarmupFrames);
+    const float gy = gravity * deltaTime * deltaTime;
+
+    alignas(sizeof(float) * Lanes) float carry[Lanes];
+    alignas(sizeof(float) * Lanes) float factor[Lanes];
+    for (int l = 0; l < Lanes; l++)
+    {
+        carry[l] = std::pow(lp.damping[l], deltaTime / Cloth::kReferenceStep) * (deltaTime / prevDt);
+        factor[l] = warmup ? Cloth::kCorrectionFactorWarmup : lp.factor[l];
+    }
+
+    for (int k = 0; k < numParticles; k++)
+    {
+        if (fixed[k]) continue;
+        LaneVec3& p = P[k];
+        LaneVec3& q = Q[k];
+        for (int l = 0; l < Lanes; l++)
+        {
+            const float sx = (p.x[l] - q.x[l]) * carry[l];
+            const float sy = (p.y[l] - q.y[l]) * carry[l] + gy;
+            const float sz = (p.z[l] - q.z[l]) * carry[l];
+            q.x[l] = p.x[l];
+            q.y[l] = p.y[l];
+            q.z[l] = p.z[l];
+            p.x[l] += sx;
+            p.y[l] += sy;
+            p.z[l] += sz;
+        }
+    }
+
+    alignas(sizeof(float) * Lanes) float cx[Lanes], cy[Lanes], cz[Lanes];
+    for (int it = 0; it < iterations; it++)
+    {
+        for (const BatchSpring& s : springs)
+        {
+            LaneVec3& a = P[s.p1];
+            LaneVec3& b = P[s.p2];
+            for (int l = 0; l < Lanes; l++)
+            {
+                const float dx = b.x[l] - a.x[l];
+                const float dy = b.y[l] - a.y[l];
+                const float dz = b.z[l] - a.z[l];
+                const float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+                const float rest = s.restUnit * lp.spacing[l];
+                // 나눗셈을 먼저 하고 결과만 고르면 분기 없이 벡터화됨
+                const float k = factor[l] * (dist - rest) / std::max(dist, 1e-8f);
+                const float scale = (dist > 1e-8f) ? k : 0.0f;
+                cx[l] = dx * scale;
+                cy[l] = dy * scale;
+                cz[l] = dz * scale;
+            }
+
+            // 고정 여부는 파티클마다 같으므로 레인 밖에서 한 번만 확인
+            if (!fixed[s.p1])
+            {
+                for (int l = 0; l < Lanes; l++)
+                {
+                    a.x[l] += cx[l];
+                    a.y[l] += cy[l];
+                    a.z[l] += cz[l];
+                }
+            }
+            if (!fixed[s.p2])
+            {
+                for (int l = 0; l < Lanes; l++)
+                {
+                    b.x[l] -= cx[l];
+                    b.y[l] -= cy[l];
+                    b.z[l] -= cz[l];
+                }
+            }
+        }
+    }
+}
+
+template class BasicClothBatch<1>;
+template class BasicClothBatch<8>;
+template class BasicClothBatch<16>;
+
+namespace
+{
+    const float kBatchStep = 1.0f / 60.0f;
+
+    template<int Lanes>
+    double runSweep(const std::vector<BatchInstanceParams>& sweep, int steps, std::vector<glm::vec3>& out)
+    {
+        BasicClothBatch<Lanes> batch(20, 20, sweep);
+        auto t0 = std::chrono::steady_clock::now();
+        for (int s = 0; s < steps; s++)
+            batch.step(kBatchStep);
+        auto t1 = std::chrono::steady_clock::now();
+
+        out.clear();
+        for (int i = 0; i < batch.getInstanceCount(); i++)
+            for (int k = 0; k < batch.getParticleCount(); k++)
+                out.push_back(batch.getParticlePos(i, k));
+        return std::chrono::duration<double>(t1 - t0).count();
+    }
+}
+
+int runBatchBenchmark(int instances, int steps)
+{
+    // 간격/감쇠/보정 계수를 격자로 훑는 스윕
+    std::vector<BatchInstanceParams> sweep(std::max(1, instances));
+    for (size_t i = 0; i < sweep.size(); i++)
+    {
+        sweep[i].spacing = 0.05f + 0.01f * static_cast<float>(i % 8);
+        sweep[i].damping = 0.95f + 0.005f * static_cast<float>((i / 8) % 9);
+        sweep[i].correctionFactor = 0.15f + 0.02f * static_cast<float>((i / 72) % 8);
+    }
+
+    std::printf("batch benchmark: %zu instances of 20x20, %d steps\n", sweep.size(), steps);
+    std::vector<glm::vec3> scalar, lanes8, lanes16;
+    const double t1 = runSweep<1>(sweep, steps, scalar);
+    const double t8 = runSweep<8>(sweep, steps, lanes8);
+    const double t16 = runSweep<16>(sweep, steps, lanes16);
+
+    auto maxDiff = [&](const std::vector<glm::vec3>& a) {
+        float e = 0.0f;
+        for (size_t i = 0; i < a.size(); i++) e = std::max(e, glm::length(a[i] - scalar[i]));
+        return e;
+    };
+    const double work = static_cast<double>(sweep.size()) * steps;
+    std::printf("  lanes  1: %10.0f instance-steps/s\n", work / t1);
+    std::printf("  lanes  8: %10.0f instance-steps/s  x%.2f  max diff %.3e m\n", work / t8, t1 / t8, maxDiff(lanes8));
+    std::printf("  lanes 16: %10.0f instance-steps/s  x%.2f  max diff %.3e m\n", work / t16, t1 / t16, maxDiff(lanes16));
+    return 0;
+}
@@ -0,0 +1,83 @@
+﻿#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// 배치 인스턴스별 파라미터
+struct BatchInstanceParams
+{
+    float spacing = 0.1f;
+    float damping = 0.99f;            // kReferenceStep당 속도 유지 비율 (Cloth::kDamping)
+    float correctionFactor = 0.22f;   // 안정 구간 스프링 보정 계수 (Cloth::kCorrectionFactorStable)
+};
+
+// 작은 격자 천 여러 개를 SIMD 레인으로 묶어 함께 푸는 배치 시뮬레이터 (파라미터 스윕용)
+// AoSoA 배치: 묶음(Lanes개 인스턴스)마다 파티클 k의 x/y/z가 레인 배열로 연속 (레인 i = 인스턴스 i)
+// 토폴로지는 모든 인스턴스가 Cloth::initSprings 결과를 공유하고, 간격/감쇠/보정 계수만 인스턴스별로 다름
+template<int Lanes>
+class BasicClothBatch
+{
+public:
+    static const int kLanes = Lanes;
+
+    using InstanceParams = BatchInstanceParams;
+
+    BasicClothBatch(int width, int height, const std::vector<InstanceParams>& instances);
+
+    // 모든 인스턴스를 한 스텝 진행 (중력 워밍업은 Cloth와 같음)
+    void step(float deltaTime);
+
+    void setIterations(int iters) { iterations = iters; }
+    int getIterations() const { return iterations; }
+
+    int getInstanceCount() const { return static_cast<int>(params.size()); }
+    int getParticleCount() const { return numParticles; }
+    const InstanceParams& getParams(int instance) const { return params[instance]; }
+    glm::vec3 getParticlePos(int instance, int idx) const;
+
+private:
+    struct LaneVec3
+    {
+        alignas(sizeof(float) * Lanes) float x[Lanes];
+        float y[Lanes];
+        float z[Lanes];
+    };
+
+    struct BatchSpring
+    {
+        int p1, p2;
+        float restUnit;   // 간격 1 기준 자연 길이 (인스턴스 간격을 곱해 씀)
+    };
+
+    // 묶음별 레인 파라미터
+    struct LaneParams
+    {
+        alignas(sizeof(float) * Lanes) float spacing[Lanes];
+        float damping[Lanes];
+        float factor[Lanes];
+    };
+
+    int numWidth, numHeight, numParticles;
+    int numBlocks;
+    int iterations;
+    int frameCount = 0;
+    float lastStepDt = 0.0f;
+
+    std::vector<InstanceParams> params;
+    std::vector<LaneParams> laneParams;     // 묶음 수만큼
+    std::vector<LaneVec3> pos;              // [묶음][파티클]
+    std::vector<LaneVec3> prevPos;
+    std::vector<BatchSpring> springs;
+    std::vector<unsigned char> fixed;       // 토폴로지 공유라 파티클별 하나
+
+    void stepBlock(int block, float deltaTime, float prevDt, bool warmup);
+};
+
+using ClothBatch = BasicClothBatch<8>;
+
+// 스윕 처리량 벤치마크: 같은 인스턴스들을 레인 1 / 8 / 16으로 돌려 인스턴스-스텝/초와 결과 차이 출력
+int runBatchBenchmark(int instances, int steps);
+
+extern template class BasicClothBatch<1>;
+extern template class BasicClothBatch<8>;
+extern template class BasicClothBatch<16>;
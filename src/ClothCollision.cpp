@@ -0,0 +1,359 @@
+﻿#include "ClothCollision.h"
+#include "Cloth.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace
+{
+    const int kTileTris = 16;
+    const int kTileParticles = 16;
+
+    // 점에서 가장 가까운 삼각형 위의 점 (무게중심 좌표 반환)
+    glm::vec3 closestBary(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+    {
+        const glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+        const float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+        if (d1 <= 0.0f && d2 <= 0.0f) return glm::vec3(1, 0, 0);
+
+        const glm::vec3 bp = p - b;
+        const float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+        if (d3 >= 0.0f && d4 <= d3) return glm::vec3(0, 1, 0);
+
+        const float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        {
+            const float v = d1 / (d1 - d3);
+            return glm::vec3(1.0f - v, v, 0.0f);
+        }
+
+        const glm::vec3 cp = p - c;
+        const float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+        if (d6 >= 0.0f && d5 <= d6) return glm::vec3(0, 0, 1);
+
+        const float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        {
+            const float w = d2 / (d2 - d6);
+            return glm::vec3(1.0f - w, 0.0f, w);
+        }
+
+        const float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        {
+            const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            return glm::vec3(0.0f, 1.0f - w, w);
+        }
+
+        const float denom = 1.0f / (va + vb + vc);
+        const float v = vb * denom, w = vc * denom;
+        return glm::vec3(1.0f - v - w, v, w);
+    }
+}
+
+template<class ClothT>
+void ClothCollisionWorld<ClothT>::addCloth(ClothT* cloth)
+{
+    if (cloth && std::find(cloths.begin(), cloths.end(), cloth) == cloths.end())
+        cloths.push_back(cloth);
+}
+
+template<class ClothT>
+void ClothCollisionWorld<ClothT>::removeCloth(ClothT* cloth)
+{
+    cloths.erase(std::remove(cloths.begin(), cloths.end(), cloth), cloths.end());
+}
+
+template<class ClothT>
+void ClothCollisionWorld<ClothT>::advance(float frameTime)
+{
+    lastSubsteps = 0;
+    int maxSubsteps = 1;
+    for (ClothT* c : cloths)
+        maxSubsteps = std::max(maxSubsteps, c->getTimeStep().maxSubsteps);
+
+    float remaining = frameTime;
+    while (remaining > 1e-6f && lastSubsteps < maxSubsteps)
+    {
+        float dt = remaining;
+        for (ClothT* c : cloths)
+            dt = std::min(dt, c->nextStepSize(remaining));
+        for (ClothT* c : cloths)
+            c->update(dt);
+        solve();
+        remaining -= dt;
+        lastSubsteps++;
+    }
+}
+
+template<class ClothT>
+void ClothCollisionWorld<ClothT>::solve()
+{
+    stats = Stats();
+    contacts.clear();
+    if (cloths.size() < 2 || thickness <= 0.0f) return;
+
+    // 천 구성이 바뀌었거나 정점 수가 바뀐(찢어짐) 천은 이전 위치를 쓰지 않음
+    hasHistory.resize(cloths.size(), 0);
+    for (size_t c = 0; c < cloths.size(); c++)
+    {
+        if (c >= historyOwner.size() || historyOwner[c] != cloths[c]
+            || history[c].size() != cloths[c]->getParticles().size())
+            hasHistory[c] = 0;
+    }
+
+    buildBoxes();
+    sweepAndPrune();
+    narrowphase();
+    resolve();
+    storeHistory();
+}
+
+// 천마다 삼각형 타일(인덱스 순 kTileTris개)과 파티클 타일(kTileParticles개)의 상자
+// 힐베르트 재배열/그리드 행 순서 덕분에 연속 구간이 공간적으로도 모여 있음
+template<class ClothT>
+void ClothCollisionWorld<ClothT>::buildBoxes()
+{
+    views.resize(cloths.size());
+    size_t numBoxes = 0;
+    for (size_t c = 0; c < cloths.size(); c++)
+    {
+        ClothView& v = views[c];
+        v.pos = cloths[c]->floatPositions(v.stride);
+        v.indices = cloths[c]->getIndices().data();
+        v.triCount = static_cast<int>(cloths[c]->getIndices().size() / 3);
+        v.particleCount = static_cast<int>(cloths[c]->getParticles().size());
+        numBoxes += (v.triCount + kTileTris - 1) / kTileTris + (v.particleCount + kTileParticles - 1) / kTileParticles;
+    }
+
+    boxes.clear();
+    boxes.reserve(numBoxes);
+    for (size_t c = 0; c < cloths.size(); c++)
+    {
+        const ClothView& v = views[c];
+        if (!v.pos) continue;
+        for (int t = 0; t < v.triCount; t += kTileTris)
+            boxes.push_back({ glm::vec3(0.0f), glm::vec3(0.0f), static_cast<int>(c), t, std::min(kTileTris, v.triCount - t), true });
+        for (int p = 0; p < v.particleCount; p += kTileParticles)
+            boxes.push_back({ glm::vec3(0.0f), glm::vec3(0.0f), static_cast<int>(c), p, std::min(kTileParticles, v.particleCount - p), false });
+    }
+
+    const glm::vec3 pad(thickness);
+    parallelFor(static_cast<int>(boxes.size()), [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            Box& b = boxes[i];
+            const ClothView& v = views[b.cloth];
+            glm::vec3 bmin(1e30f), bmax(-1e30f);
+            if (b.triangles)
+            {
+                for (int k = b.first * 3; k < (b.first + b.count) * 3; k++)
+                {
+                    bmin = glm::min(bmin, v.at(v.indices[k]));
+                    bmax = glm::max(bmax, v.at(v.indices[k]));
+                }
+            }
+            else
+            {
+                for (int k = b.first; k < b.first + b.count; k++)
+                {
+                    bmin = glm::min(bmin, v.at(k));
+                    bmax = glm::max(bmax, v.at(k));
+                }
+            }
+            b.bmin = bmin - pad;
+            b.bmax = bmax + pad;
+        }
+    }, 64);
+
+    stats.tiles = static_cast<int>(boxes.size());
+}
+
+// x축으로 정렬한 뒤 열린 구간 목록만 비교 (겹침이 없으면 거의 선형)
+template<class ClothT>
+void ClothCollisionWorld<ClothT>::sweepAndPrune()
+{
+    sweepOrder.resize(boxes.size());
+    for (size_t i = 0; i < boxes.size(); i++) sweepOrder[i] = static_cast<int>(i);
+    std::sort(sweepOrder.begin(), sweepOrder.end(), [&](int a, int b) { return boxes[a].bmin.x < boxes[b].bmin.x; });
+
+    pairs.clear();
+    std::vector<int> active;
+    for (int i : sweepOrder)
+    {
+        const Box& bi = boxes[i];
+        size_t keep = 0;
+        for (size_t k = 0; k < active.size(); k++)
+        {
+            const Box& bj = boxes[active[k]];
+            if (bj.bmax.x < bi.bmin.x) continue; // 다시는 겹칠 수 없음
+            active[keep++] = active[k];
+
+            if (bj.cloth == bi.cloth || bj.triangles == bi.triangles) continue;
+            if (bj.bmin.y > bi.bmax.y || bj.bmax.y < bi.bmin.y || bj.bmin.z > bi.bmax.z || bj.bmax.z < bi.bmin.z) continue;
+            pairs.emplace_back(bi.triangles ? i : active[k], bi.triangles ? active[k] : i);
+        }
+        active.resize(keep);
+        active.push_back(i);
+    }
+
+    stats.candidatePairs = static_cast<int>(pairs.size());
+}
+
+// 후보 쌍마다 파티클 타일 x 삼각형 타일 근접 검사 (병렬, 구간별로 모아 한 번만 잠금)
+template<class ClothT>
+void ClothCollisionWorld<ClothT>::narrowphase()
+{
+    std::mutex merge;
+    const float h2 = thickness * thickness;
+    const glm::vec3 pad(thickness);
+
+    parallelFor(static_cast<int>(pairs.size()), [&](int begin, int end) {
+        std::vector<Contact> local;
+        for (int pi = begin; pi < end; pi++)
+        {
+            const Box& tb = boxes[pairs[pi].first];
+            const Box& pb = boxes[pairs[pi].second];
+            const ClothView& tv = views[tb.cloth];
+            const ClothView& pv = views[pb.cloth];
+
+            for (int p = pb.first; p < pb.first + pb.count; p++)
+            {
+                const glm::vec3& x = pv.at(p);
+                if (x.x < tb.bmin.x || x.y < tb.bmin.y || x.z < tb.bmin.z
+                    || x.x > tb.bmax.x || x.y > tb.bmax.y || x.z > tb.bmax.z) continue;
+
+                for (int t = tb.first; t < tb.first + tb.count; t++)
+                {
+                    const unsigned int* tri = tv.indices + static_cast<size_t>(t) * 3;
+                    const glm::vec3& a = tv.at(tri[0]);
+                    const glm::vec3& b = tv.at(tri[1]);
+                    const glm::vec3& c = tv.at(tri[2]);
+
+                    // 삼각형 상자(두께 포함) 밖이면 최근접점 계산 생략
+                    const glm::vec3 lo = glm::min(glm::min(a, b), c) - pad;
+                    const glm::vec3 hi = glm::max(glm::max(a, b), c) + pad;
+                    if (x.x < lo.x || x.y < lo.y || x.z < lo.z || x.x > hi.x || x.y > hi.y || x.z > hi.z) continue;
+
+                    const glm::vec3 bary = closestBary(x, a, b, c);
+                    const glm::vec3 q = a * bary.x + b * bary.y + c * bary.z;
+                    const glm::vec3 d = x - q;
+                    const float d2 = glm::dot(d, d);
+                    if (d2 >= h2) continue;
+
+                    glm::vec3 n = glm::cross(b - a, c - a);
+                    const float len = glm::length(n);
+                    if (len < 1e-12f) continue;
+                    n /= len;
+
+                    // 면 법선 방향은 직전 solve 이후(충돌이 풀린 상태)에 파티클이 있던 쪽으로
+                    // 한 서브스텝 안에 면을 넘어가도 원래 쪽으로 되돌림
+                    float side;
+                    if (hasHistory[tb.cloth] && hasHistory[pb.cloth])
+                    {
+                        const std::vector<glm::vec3>& ht = history[tb.cloth];
+                        const glm::vec3 qPrev = ht[tri[0]] * bary.x + ht[tri[1]] * bary.y + ht[tri[2]] * bary.z;
+                        side = glm::dot(history[pb.cloth][p] - qPrev, n);
+                    }
+                    else
+                    {
+                        side = glm::dot(d, n);
+                    }
+                    if (side < 0.0f) n = -n;
+
+                    const float sd = glm::dot(d, n);
+                    if (sd >= thickness) continue;
+                    local.push_back({ pb.cloth, p, tb.cloth, t, bary, n, thickness - sd });
+                }
+            }
+        }
+        if (!local.empty())
+        {
+            std::lock_guard<std::mutex> lock(merge);
+            contacts.insert(contacts.end(), local.begin(), local.end());
+        }
+    }, 4);
+
+    // 병합 순서는 스레드마다 달라지므로 정렬해 보정 합산 순서를 고정 (결과 재현성)
+    std::sort(contacts.begin(), contacts.end(), [](const Contact& a, const Contact& b) {
+        if (a.particleCloth != b.particleCloth) return a.particleCloth < b.particleCloth;
+        if (a.particle != b.particle) return a.particle < b.particle;
+        if (a.triCloth != b.triCloth) return a.triCloth < b.triCloth;
+        return a.tri < b.tri;
+    });
+    stats.contacts = static_cast<int>(contacts.size());
+}
+
+// 접촉마다 파티클과 삼각형 세 정점을 법선 방향으로 벌림 (무게중심 가중, 고정점은 질량 무한대)
+// 한 파티클에 여러 접촉이 걸리면 평균을 적용해 순서와 무관하게 함
+template<class ClothT>
+void ClothCollisionWorld<ClothT>::resolve()
+{
+    if (contacts.empty()) return;
+
+    correction.resize(cloths.size());
+    for (size_t c = 0; c < cloths.size(); c++)
+        correction[c].assign(views[c].particleCount, glm::vec4(0.0f));
+
+    for (const Contact& ct : contacts)
+    {
+        const ClothT& pc = *cloths[ct.particleCloth];
+        const ClothT& tc = *cloths[ct.triCloth];
+        const unsigned int* tri = views[ct.triCloth].indices + static_cast<size_t>(ct.tri) * 3;
+
+        const float wp = pc.isParticleFixed(ct.particle) ? 0.0f : 1.0f;
+        float w[3];
+        float denom = wp;
+        for (int k = 0; k < 3; k++)
+        {
+            w[k] = tc.isParticleFixed(static_cast<int>(tri[k])) ? 0.0f : 1.0f;
+            denom += w[k] * ct.bary[k] * ct.bary[k];
+        }
+        if (denom <= 0.0f) continue;
+
+        const float s = ct.depth / denom;
+        correction[ct.particleCloth][ct.particle] += glm::vec4(ct.normal * (wp * s), 1.0f);
+        for (int k = 0; k < 3; k++)
+        {
+            if (w[k] == 0.0f || ct.bary[k] == 0.0f) continue;
+            correction[ct.triCloth][tri[k]] += glm::vec4(ct.normal * (-w[k] * ct.bary[k] * s), 1.0f);
+        }
+    }
+
+    for (size_t c = 0; c < cloths.size(); c++)
+    {
+        bool moved = false;
+        for (int i = 0; i < views[c].particleCount; i++)
+        {
+            const glm::vec4& d = correction[c][i];
+            if (d.w == 0.0f) continue;
+            cloths[c]->displaceParticle(i, glm::vec3(d) / d.w);
+            moved = true;
+        }
+        if (moved) cloths[c]->computeNormals();
+    }
+}
+
+// 보정이 끝난 위치를 다음 solve의 면 방향 판정용으로 보관
+template<class ClothT>
+void ClothCollisionWorld<ClothT>::storeHistory()
+{
+    history.resize(cloths.size());
+    historyOwner = cloths;
+    hasHistory.assign(cloths.size(), 0);
+    for (size_t c = 0; c < cloths.size(); c++)
+    {
+        size_t stride = 0;
+        const glm::vec3* pos = cloths[c]->floatPositions(stride);
+        const int n = static_cast<int>(cloths[c]->getParticles().size());
+        history[c].resize(n);
+        for (int i = 0; i < n; i++)
+            history[c][i] = *reinterpret_cast<const glm::vec3*>(reinterpret_cast<const char*>(pos) + stride * i);
+        hasHistory[c] = 1;
+    }
+}
+
+#define CLOTH_INSTANTIATE(R, S) template class ClothCollisionWorld<BasicCloth<R, S>>;
+CLOTH_PRECISIONS(CLOTH_INSTANTIATE)
+#undef CLOTH_INSTANTIATE
@@ -0,0 +1,98 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+// 여러 천 사이의 충돌 (같은 천 안의 자기 충돌은 다루지 않음)
+// 1) 천마다 삼각형 타일/파티클 타일 AABB (두께만큼 확장)
+// 2) x축 sweep-and-prune으로 서로 다른 천의 (삼각형 타일, 파티클 타일) 후보 쌍 생성
+// 3) 후보 쌍별 병렬 파티클-삼각형 근접 검사, 접촉 보정은 파티클별 평균(Jacobi)으로 한 번에 반영
+// 비용은 천 크기의 곱이 아니라 실제로 겹치는 타일 수에 비례
+template<class ClothT>
+class ClothCollisionWorld
+{
+public:
+    struct Stats
+    {
+        int tiles = 0;
+        int candidatePairs = 0;
+        int contacts = 0;
+    };
+
+    // 등록만 함 (소유하지 않음)
+    void addCloth(ClothT* cloth);
+    void removeCloth(ClothT* cloth);
+    void clear() { cloths.clear(); }
+    int getClothCount() const { return static_cast<int>(cloths.size()); }
+
+    void setThickness(float t) { thickness = t; }
+    float getThickness() const { return thickness; }
+
+    // 등록된 천을 같은 서브스텝 간격으로 진행하며 서브스텝마다 solve
+    // 간격은 천마다 제안한 값(CFL/변형률) 중 가장 짧은 것
+    void advance(float frameTime);
+    int getLastSubsteps() const { return lastSubsteps; }
+
+    // 등록된 천의 스텝이 모두 끝난 뒤 한 번 (advance를 쓰지 않을 때 직접 호출)
+    void solve();
+    const Stats& getLastStats() const { return stats; }
+
+private:
+    struct Box
+    {
+        glm::vec3 bmin;
+        glm::vec3 bmax;
+        int cloth;
+        int first;       // 타일 시작 (삼각형 또는 파티클 번호)
+        int count;
+        bool triangles;
+    };
+
+    struct Contact
+    {
+        int particleCloth;
+        int particle;
+        int triCloth;
+        int tri;
+        glm::vec3 bary;
+        glm::vec3 normal;   // 삼각형 -> 파티클
+        float depth;
+    };
+
+    struct ClothView
+    {
+        const glm::vec3* pos = nullptr;
+        size_t stride = 0;
+        const unsigned int* indices = nullptr;
+        int triCount = 0;
+        int particleCount = 0;
+
+        const glm::vec3& at(unsigned int i) const
+        {
+            return *reinterpret_cast<const glm::vec3*>(reinterpret_cast<const char*>(pos) + stride * i);
+        }
+    };
+
+    void buildBoxes();
+    void sweepAndPrune();
+    void narrowphase();
+    void resolve();
+    void storeHistory();
+
+    std::vector<ClothT*> cloths;
+    float thickness = 0.02f;
+    Stats stats;
+    int lastSubsteps = 0;
+
+    std::vector<ClothView> views;
+    std::vector<Box> boxes;
+    std::vector<int> sweepOrder;
+    std::vector<std::pair<int, int>> pairs;   // (삼각형 타일, 파티클 타일)
+    std::vector<Contact> contacts;
+    std::vector<std::vector<glm::vec4>> correction; // 천별 파티클 보정 합 (w = 접촉 수)
+    std::vector<std::vector<glm::vec3>> history;    // 직전 solve 직후 위치 (면 방향 판정)
+    std::vector<ClothT*> historyOwner;
+    std::vector<unsigned char> hasHistory;
+};
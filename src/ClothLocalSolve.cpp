@@ -0,0 +1,124 @@
+﻿#include "Cloth.h"
+#include <algorithm>
+#include <cmath>
+
+// 상호작용 지점 추가 (같은 파티클이 여러 번 들어와도 BFS 표시로 한 번만 처리)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::markInteraction(int particle)
+{
+    if (localSolve.iterations <= 0 || particle < 0 || particle >= static_cast<int>(particles.size())) return;
+    localSeeds.push_back({ particle, localSolve.holdSteps });
+}
+
+// 상호작용 지점에서 스프링 그래프로 hops 단계 안의 스프링을 모아 iterations번 Gauss-Seidel 순회
+// 인덱스 순으로 정렬해 종류별 묶음과 메모리 순서를 유지, 반환값은 순회한 스프링 수 (반복 합)
+template<class Real, class SolveReal>
+int BasicCloth<Real, SolveReal>::solveLocal()
+{
+    const int n = static_cast<int>(particles.size());
+    const int numSprings = static_cast<int>(springs.size());
+
+    // 정점 -> 스프링 CSR (토폴로지가 바뀔 때만)
+    if (localAdjDirty || static_cast<int>(localAdjStart.size()) != n + 1
+        || static_cast<int>(localSpringMark.size()) != numSprings)
+    {
+        localAdjStart.assign(n + 1, 0);
+        for (const Spring& s : springs)
+        {
+            localAdjStart[s.p1 + 1]++;
+            localAdjStart[s.p2 + 1]++;
+        }
+        for (int i = 0; i < n; i++) localAdjStart[i + 1] += localAdjStart[i];
+        localAdj.resize(localAdjStart[n]);
+        std::vector<int> cursor(localAdjStart.begin(), localAdjStart.end() - 1);
+        for (int i = 0; i < numSprings; i++)
+        {
+            localAdj[cursor[springs[i].p1]++] = i;
+            localAdj[cursor[springs[i].p2]++] = i;
+        }
+        localParticleMark.assign(n, 0);
+        localSpringMark.assign(numSprings, 0);
+        localStamp = 0;
+        localAdjDirty = false;
+    }
+    if (++localStamp == 0)
+    {
+        std::fill(localParticleMark.begin(), localParticleMark.end(), 0u);
+        std::fill(localSpringMark.begin(), localSpringMark.end(), 0u);
+        localStamp = 1;
+    }
+
+    localFrontier.clear();
+    localSprings.clear();
+    for (const LocalSeed& seed : localSeeds)
+    {
+        if (seed.particle >= n || localParticleMark[seed.particle] == localStamp) continue;
+        localParticleMark[seed.particle] = localStamp;
+        localFrontier.push_back(seed.particle);
+    }
+    for (int hop = 0; hop < localSolve.hops && !localFrontier.empty(); hop++)
+    {
+        localNext.clear();
+        for (int v : localFrontier)
+        {
+            for (int k = localAdjStart[v]; k < localAdjStart[v + 1]; k++)
+            {
+                const int si = localAdj[k];
+                if (localSpringMark[si] != localStamp)
+                {
+                    localSpringMark[si] = localStamp;
+                    localSprings.push_back(si);
+                }
+                const Spring& s = springs[si];
+                const int w = (s.p1 == v) ? s.p2 : s.p1;
+                if (localParticleMark[w] == localStamp) continue;
+                localParticleMark[w] = localStamp;
+                localNext.push_back(w);
+            }
+        }
+        std::swap(localFrontier, localNext);
+    }
+    std::sort(localSprings.begin(), localSprings.end());
+
+    using SolveVec3 = glm::vec<3, SolveReal>;
+    const SolveReal factor = (frameCount < BasicCloth::kGravityWarmupFrames)
+        ? BasicCloth::kCorrectionFactorWarmup
+        : BasicCloth::kCorrectionFactorStable;
+    for (int it = 0; it < localSolve.iterations; it++)
+    {
+        for (int si : localSprings)
+        {
+            const Spring& s = springs[si];
+            Particle& p1 = particles[s.p1];
+            Particle& p2 = particles[s.p2];
+
+            SolveVec3 delta(p2.pos - p1.pos);
+            SolveReal dist = glm::length(delta);
+            if (dist < SolveReal(1e-8f)) continue;
+
+            const SolveReal k = factor * SolveReal(springStiffness[static_cast<int>(s.type)]);
+            const SolveReal rest = s.restLength;
+            SolveReal diff = (dist - rest) / dist;
+            Vec3 correction(delta * (k * diff));
+            p1.pos += correction * (p1.isFixed ? Real(0) : Real(1));
+            p2.pos -= correction * (p2.isFixed ? Real(0) : Real(1));
+        }
+    }
+
+    // 유지 시간이 지난 지점 제거
+    size_t kept = 0;
+    for (LocalSeed& seed : localSeeds)
+    {
+        if (--seed.stepsLeft > 0 && seed.particle < n) localSeeds[kept++] = seed;
+    }
+    localSeeds.resize(kept);
+
+    lastLocalSprings = static_cast<int>(localSprings.size());
+    return lastLocalSprings * localSolve.iterations;
+}
+
+#define CLOTH_INSTANTIATE(R, S) \
+    template void BasicCloth<R, S>::markInteraction(int); \
+    template int BasicCloth<R, S>::solveLocal();
+CLOTH_PRECISIONS(CLOTH_INSTANTIATE)
+#undef CLOTH_INSTANTIATE
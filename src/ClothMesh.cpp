@@ -0,0 +1,355 @@
+﻿#include "Cloth.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+
+namespace
+{
+    // 에지에 인접한 두 삼각형의 반대편 정점
+    struct EdgeInfo
+    {
+        int opp0 = -1;
+        int opp1 = -1;
+    };
+
+    // 2D 좌표 -> 힐베르트 곡선 상의 거리 (order비트 격자)
+    std::uint64_t hilbertIndex(std::uint32_t x, std::uint32_t y, int order)
+    {
+        const std::uint32_t n = 1u << order;
+        std::uint64_t d = 0;
+        for (std::uint32_t s = n >> 1; s > 0; s >>= 1)
+        {
+            std::uint32_t rx = (x & s) ? 1u : 0u;
+            std::uint32_t ry = (y & s) ? 1u : 0u;
+            d += static_cast<std::uint64_t>(s) * s * ((3u * rx) ^ ry);
+
+            if (ry == 0)
+            {
+                if (rx == 1)
+                {
+                    x = n - 1 - x;
+                    y = n - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+
+    // OBJ 면 토큰의 정점/UV 인덱스 (음수 인덱스는 끝에서부터)
+    bool parseFaceToken(const std::string& tok, int numV, int numVT, int& v, int& vt)
+    {
+        v = -1; vt = -1;
+        size_t s1 = tok.find('/');
+        try {
+            int vi = std::stoi(tok.substr(0, s1));
+            v = (vi < 0) ? numV + vi : vi - 1;
+            if (s1 != std::string::npos)
+            {
+                size_t s2 = tok.find('/', s1 + 1);
+                std::string t = tok.substr(s1 + 1, (s2 == std::string::npos) ? std::string::npos : s2 - s1 - 1);
+                if (!t.empty())
+                {
+                    int ti = std::stoi(t);
+                    vt = (ti < 0) ? numVT + ti : ti - 1;
+                }
+            }
+        }
+        catch (...) {
+            return false;
+        }
+        return v >= 0 && v < numV;
+    }
+}
+
+// OBJ 패널을 읽어 메시 천 구성 (에지 -> 구조 스프링, 인접 삼각형의 반대 정점 -> 굽힘 스프링)
+template<class Real, class SolveReal>
+bool BasicCloth<Real, SolveReal>::loadFromOBJ(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Failed to open cloth mesh: " << path << "\n";
+        return false;
+    }
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texcoords;
+    std::vector<int> vertexUV;
+    PageVector<unsigned int> tris;
+
+    std::string line;
+    std::vector<int> faceV, faceVT;
+    while (std::getline(in, line))
+    {
+        std::istringstream ls(line);
+        std::string tag;
+        ls >> tag;
+        if (tag == "v")
+        {
+            glm::vec3 p(0.0f);
+            ls >> p.x >> p.y >> p.z;
+            positions.push_back(p);
+        }
+        else if (tag == "vt")
+        {
+            glm::vec2 t(0.0f);
+            ls >> t.x >> t.y;
+            texcoords.push_back(t);
+        }
+        else if (tag == "f")
+        {
+            faceV.clear(); faceVT.clear();
+            std::string tok;
+            while (ls >> tok)
+            {
+                int v, vt;
+                if (!parseFaceToken(tok, (int)positions.size(), (int)texcoords.size(), v, vt)) continue;
+                faceV.push_back(v);
+                faceVT.push_back(vt);
+            }
+            if (vertexUV.size() < positions.size()) vertexUV.resize(positions.size(), -1);
+
+            // 다각형은 팬(fan)으로 삼각형 분할
+            for (size_t k = 1; k + 1 < faceV.size(); k++)
+            {
+                tris.push_back(faceV[0]);
+                tris.push_back(faceV[k]);
+                tris.push_back(faceV[k + 1]);
+            }
+            for (size_t k = 0; k < faceV.size(); k++)
+            {
+                if (vertexUV[faceV[k]] < 0 && faceVT[k] >= 0 && faceVT[k] < (int)texcoords.size())
+                    vertexUV[faceV[k]] = faceVT[k];
+            }
+        }
+    }
+
+    if (positions.empty() || tris.empty()) {
+        std::cerr << "Cloth mesh has no triangles: " << path << "\n";
+        return false;
+    }
+    vertexUV.resize(positions.size(), -1);
+
+    // 면이 쓰지 않는 정점은 버림 (스프링 없이 떨어지기만 하고 바운딩 박스도 왜곡)
+    {
+        std::vector<int> remap(positions.size(), -1);
+        int used = 0;
+        for (unsigned int& v : tris)
+        {
+            if (remap[v] < 0) remap[v] = used++;
+            v = static_cast<unsigned int>(remap[v]);
+        }
+        std::vector<glm::vec3> usedPositions(used);
+        std::vector<int> usedUV(used);
+        for (size_t i = 0; i < positions.size(); i++)
+        {
+            if (remap[i] < 0) continue;
+            usedPositions[remap[i]] = positions[i];
+            usedUV[remap[i]] = vertexUV[i];
+        }
+        positions = std::move(usedPositions);
+        vertexUV = std::move(usedUV);
+    }
+
+    // 바운딩 박스 (UV 대체값/코너 검출용)
+    glm::vec3 bmin = positions[0], bmax = positions[0];
+    for (const auto& p : positions) {
+        bmin = glm::min(bmin, p);
+        bmax = glm::max(bmax, p);
+    }
+    glm::vec3 ext = bmax - bmin;
+
+    // 두께 방향(가장 얇은 축)을 버리고 패널 평면의 2D 축 선택
+    int dropAxis = 2;
+    if (ext.x <= ext.y && ext.x <= ext.z) dropAxis = 0;
+    else if (ext.y <= ext.x && ext.y <= ext.z) dropAxis = 1;
+    const int ax = (dropAxis == 0) ? 1 : 0;
+    const int ay = (dropAxis == 2) ? 1 : 2;
+
+    particles.clear();
+    particles.reserve(positions.size());
+    uvs.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        particles.emplace_back(Vec3(positions[i]));
+        if (vertexUV[i] >= 0)
+        {
+            uvs[i] = texcoords[vertexUV[i]];
+        }
+        else
+        {
+            float u = (ext[ax] > 0.0f) ? (positions[i][ax] - bmin[ax]) / ext[ax] : 0.0f;
+            float v = (ext[ay] > 0.0f) ? (bmax[ay] - positions[i][ay]) / ext[ay] : 0.0f;
+            uvs[i] = glm::vec2(u, v);
+        }
+        particles[i].uv = uvs[i];
+    }
+    indices = std::move(tris);
+
+    // 해시 기반 에지 추출
+    std::unordered_map<std::uint64_t, EdgeInfo> edges;
+    edges.reserve(indices.size());
+    for (size_t t = 0; t + 2 < indices.size(); t += 3)
+    {
+        for (int e = 0; e < 3; e++)
+        {
+            unsigned int a = indices[t + e];
+            unsigned int b = indices[t + (e + 1) % 3];
+            int opp = static_cast<int>(indices[t + (e + 2) % 3]);
+            EdgeInfo& info = edges[edgeKey(a, b)];
+            if (info.opp0 < 0) info.opp0 = opp;
+            else if (info.opp1 < 0) info.opp1 = opp;
+        }
+    }
+
+    springs.clear();
+    springs.reserve(edges.size() * 2);
+    double edgeLenSum = 0.0;
+    for (const auto& [key, info] : edges)
+    {
+        int a = static_cast<int>(key >> 32);
+        int b = static_cast<int>(key & 0xffffffffu);
+        float len = glm::length(positions[b] - positions[a]);
+        springs.emplace_back(a, b, len, SpringType::Structural);
+        edgeLenSum += len;
+
+        if (info.opp0 >= 0 && info.opp1 >= 0 && info.opp0 != info.opp1)
+        {
+            springs.emplace_back(info.opp0, info.opp1,
+                glm::length(positions[info.opp1] - positions[info.opp0]), SpringType::Bend);
+        }
+    }
+
+    gridTopology = false;
+    tearTopologyReady = false;
+    bvhTopologyDirty = true;
+    springColorsDirty = true;
+    numWidth = static_cast<int>(particles.size());
+    numHeight = 1;
+    gridW = gridH = 0;
+    spacing = edges.empty() ? 0.0f : static_cast<float>(edgeLenSum / edges.size());
+    frameCount = 0;
+    lastSolveStats = SolveStats();
+    lastStepDt = lastMaxSpeed = lastStrainGrowth = 0.0f;
+    contactQueryPos.clear();
+    cachedContacts.clear();
+    localSeeds.clear();
+    positionVersion++;
+
+    reorderHilbert();
+
+    // 코너: 패널 평면에서 대각 방향 극값 정점 (TL, TR, BL, BR)
+    const float signX[4] = { -1.0f, 1.0f, -1.0f, 1.0f };
+    const float signY[4] = { 1.0f, 1.0f, -1.0f, -1.0f };
+    for (int c = 0; c < 4; c++)
+    {
+        float best = -1e30f;
+        for (int i = 0; i < (int)particles.size(); i++)
+        {
+            const glm::vec3 p(particles[i].restPos);
+            float score = signX[c] * p[ax] + signY[c] * p[ay];
+            if (score > best) { best = score; corners[c] = i; }
+        }
+    }
+    pinAnchors = { corners[0], corners[1] };
+    resetInitialFixed();
+
+    if (vao) {
+        destroyGL();
+        initGL();
+    }
+
+    std::cout << "Loaded cloth mesh: " << path << " (" << particles.size() << " particles, "
+        << springs.size() << " springs, " << indices.size() / 3 << " triangles)\n";
+    return true;
+}
+
+// 힐베르트 곡선 순서로 파티클/스프링/삼각형 재배열 (캐시 지역성)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::reorderHilbert()
+{
+    const int n = static_cast<int>(particles.size());
+    if (n < 2) return;
+
+    glm::vec3 bmin(particles[0].restPos), bmax(particles[0].restPos);
+    for (const auto& p : particles) {
+        bmin = glm::min(bmin, glm::vec3(p.restPos));
+        bmax = glm::max(bmax, glm::vec3(p.restPos));
+    }
+    glm::vec3 ext = bmax - bmin;
+    int dropAxis = 2;
+    if (ext.x <= ext.y && ext.x <= ext.z) dropAxis = 0;
+    else if (ext.y <= ext.x && ext.y <= ext.z) dropAxis = 1;
+    const int ax = (dropAxis == 0) ? 1 : 0;
+    const int ay = (dropAxis == 2) ? 1 : 2;
+
+    const int order = 16;
+    const float cells = static_cast<float>((1 << order) - 1);
+    std::vector<std::uint64_t> keys(n);
+    for (int i = 0; i < n; i++)
+    {
+        const glm::vec3 p(particles[i].restPos);
+        float fx = (ext[ax] > 0.0f) ? (p[ax] - bmin[ax]) / ext[ax] : 0.0f;
+        float fy = (ext[ay] > 0.0f) ? (p[ay] - bmin[ay]) / ext[ay] : 0.0f;
+        keys[i] = hilbertIndex(static_cast<std::uint32_t>(fx * cells),
+            static_cast<std::uint32_t>(fy * cells), order);
+    }
+
+    std::vector<int> perm(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::stable_sort(perm.begin(), perm.end(), [&](int a, int b) { return keys[a] < keys[b]; });
+
+    std::vector<int> remap(n);
+    PageVector<Particle> sortedParticles;
+    sortedParticles.reserve(n);
+    std::vector<glm::vec2> sortedUVs(uvs.empty() ? 0 : n);
+    for (int newIdx = 0; newIdx < n; newIdx++)
+    {
+        int oldIdx = perm[newIdx];
+        remap[oldIdx] = newIdx;
+        sortedParticles.push_back(particles[oldIdx]);
+        if (!uvs.empty()) sortedUVs[newIdx] = uvs[oldIdx];
+    }
+    particles = std::move(sortedParticles);
+    uvs = std::move(sortedUVs);
+
+    // 스프링: 작은 끝점 순으로 정렬 -> 스윕이 파티클 배열을 순차 접근
+    for (auto& s : springs)
+    {
+        s.p1 = remap[s.p1];
+        s.p2 = remap[s.p2];
+        if (s.p1 > s.p2) std::swap(s.p1, s.p2);
+    }
+    std::sort(springs.begin(), springs.end(), [](const Spring& a, const Spring& b) {
+        return (a.p1 != b.p1) ? a.p1 < b.p1 : a.p2 < b.p2;
+    });
+    groupSpringsByClass();
+
+    // 삼각형: 최소 정점 인덱스 순
+    const size_t numTris = indices.size() / 3;
+    std::vector<unsigned int> triOrder(numTris);
+    std::vector<unsigned int> triKey(numTris);
+    for (size_t t = 0; t < numTris; t++)
+    {
+        for (int k = 0; k < 3; k++) indices[t * 3 + k] = remap[indices[t * 3 + k]];
+        triKey[t] = std::min({ indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] });
+        triOrder[t] = static_cast<unsigned int>(t);
+    }
+    std::sort(triOrder.begin(), triOrder.end(), [&](unsigned int a, unsigned int b) { return triKey[a] < triKey[b]; });
+    PageVector<unsigned int> sortedIndices(numTris * 3);
+    for (size_t t = 0; t < numTris; t++)
+    {
+        for (int k = 0; k < 3; k++) sortedIndices[t * 3 + k] = indices[triOrder[t] * 3 + k];
+    }
+    indices = std::move(sortedIndices);
+}
+
+#define CLOTH_INSTANTIATE(R, S) \
+    template bool BasicCloth<R, S>::loadFromOBJ(const std::string&); \
+    template void BasicCloth<R, S>::reorderHilbert();
+CLOTH_PRECISIONS(CLOTH_INSTANTIATE)
+#undef CLOTH_INSTANTIATE
@@ -0,0 +1,117 @@
+﻿#include "Cloth.h"
+#include "Parallel.h"
+#include <algorithm>
+
+namespace
+{
+    // 스레드별 묶음 버퍼 (묶음 크기만큼 한 번 잡아두고 재사용)
+    struct PluginScratch
+    {
+        std::vector<glm::vec3> position;
+        std::vector<glm::vec3> original;
+        std::vector<glm::vec3> velocity;
+        std::vector<glm::vec3> acceleration;
+        std::vector<std::uint8_t> pinned;
+
+        void resize(size_t n)
+        {
+            position.resize(n);
+            original.resize(n);
+            velocity.resize(n);
+            acceleration.resize(n);
+            pinned.resize(n);
+        }
+    };
+
+    // 파티클 [first, first + count)를 float 연속 배열로 모음 (속도 = (pos - prevPos) / dt)
+    template<class Real>
+    void gatherBatch(const PageVector<BasicParticle<Real>>& particles, int first, int count, float dt, PluginScratch& s)
+    {
+        const Real invDt = (dt > 0.0f) ? Real(1) / Real(dt) : Real(0);
+        for (int i = 0; i < count; i++)
+        {
+            const BasicParticle<Real>& p = particles[first + i];
+            s.position[i] = glm::vec3(p.pos);
+            s.velocity[i] = glm::vec3((p.pos - p.prevPos) * invDt);
+            s.pinned[i] = p.isFixed ? 1 : 0;
+        }
+    }
+}
+
+// 등록된 힘 플러그인을 묶음별로 병렬 실행하고 가속도에 더함
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::runForceFields(float dt)
+{
+    const int n = static_cast<int>(particles.size());
+    const int numBatches = (n + BasicCloth::kPluginBatch - 1) / BasicCloth::kPluginBatch;
+
+    parallelFor(numBatches, [&](int begin, int end) {
+        thread_local PluginScratch s;
+        s.resize(BasicCloth::kPluginBatch);
+        for (int b = begin; b < end; b++)
+        {
+            const int first = b * BasicCloth::kPluginBatch;
+            const int count = std::min(BasicCloth::kPluginBatch, n - first);
+            gatherBatch(particles, first, count, dt, s);
+            std::fill(s.acceleration.begin(), s.acceleration.begin() + count, glm::vec3(0.0f));
+
+            ForceBatch batch;
+            batch.first = first;
+            batch.time = simTime;
+            batch.dt = dt;
+            batch.position = std::span<const glm::vec3>(s.position.data(), count);
+            batch.velocity = std::span<const glm::vec3>(s.velocity.data(), count);
+            batch.pinned = std::span<const std::uint8_t>(s.pinned.data(), count);
+            batch.acceleration = std::span<glm::vec3>(s.acceleration.data(), count);
+            for (ForceField* f : forceFields)
+                f->apply(batch);
+
+            for (int i = 0; i < count; i++)
+            {
+                if (!s.pinned[i]) particles[first + i].acceleration += Vec3(s.acceleration[i]);
+            }
+        }
+    }, std::max(1, BasicCloth::kParallelGrain / BasicCloth::kPluginBatch));
+}
+
+// 등록된 제약 훅을 묶음별로 병렬 실행 (훅이 바꾼 위치만 되돌려 써서 double 저장 정밀도를 유지)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::runConstraintHooks(float dt)
+{
+    const int n = static_cast<int>(particles.size());
+    const int numBatches = (n + BasicCloth::kPluginBatch - 1) / BasicCloth::kPluginBatch;
+
+    parallelFor(numBatches, [&](int begin, int end) {
+        thread_local PluginScratch s;
+        s.resize(BasicCloth::kPluginBatch);
+        for (int b = begin; b < end; b++)
+        {
+            const int first = b * BasicCloth::kPluginBatch;
+            const int count = std::min(BasicCloth::kPluginBatch, n - first);
+            gatherBatch(particles, first, count, dt, s);
+            std::copy(s.position.begin(), s.position.begin() + count, s.original.begin());
+
+            ConstraintBatch batch;
+            batch.first = first;
+            batch.time = simTime;
+            batch.dt = dt;
+            batch.position = std::span<glm::vec3>(s.position.data(), count);
+            batch.velocity = std::span<const glm::vec3>(s.velocity.data(), count);
+            batch.pinned = std::span<const std::uint8_t>(s.pinned.data(), count);
+            for (ConstraintHook* h : constraintHooks)
+                h->project(batch);
+
+            for (int i = 0; i < count; i++)
+            {
+                if (s.pinned[i] || s.position[i] == s.original[i]) continue;
+                particles[first + i].pos += Vec3(s.position[i] - s.original[i]);
+            }
+        }
+    }, std::max(1, BasicCloth::kParallelGrain / BasicCloth::kPluginBatch));
+}
+
+#define CLOTH_INSTANTIATE(R, S) \
+    template void BasicCloth<R, S>::runForceFields(float); \
+    template void BasicCloth<R, S>::runConstraintHooks(float);
+CLOTH_PRECISIONS(CLOTH_INSTANTIATE)
+#undef CLOTH_INSTANTIATE
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <span>
+#include <glm/glm.hpp>
+
+// 외부 힘/제약 플러그인 인터페이스
+// 엔진이 파티클을 고정 크기 묶음으로 나눠 연속 배열(float)로 모은 뒤 묶음마다 한 번 호출 (파티클 단위 가상 호출 없음)
+// 묶음들은 작업 스레드에서 동시에 처리되므로 apply/project는 묶음 밖 상태를 쓰지 않아야 함
+
+// 힘 플러그인 입력: 위치/속도/고정 여부, 출력: 가속도 누적 (고정점에 쓴 값은 무시됨)
+struct ForceBatch
+{
+    int first = 0;      // 전체 파티클 배열에서 묶음 시작 인덱스
+    float time = 0.0f;  // 시뮬레이션 시간
+    float dt = 0.0f;    // 속도 계산에 쓴 스텝 길이
+    std::span<const glm::vec3> position;
+    std::span<const glm::vec3> velocity;
+    std::span<const std::uint8_t> pinned; // 1이면 고정점
+    std::span<glm::vec3> acceleration;    // 0으로 초기화되어 넘어옴
+};
+
+// 제약 훅 입력: 스프링 제약 뒤의 위치 (수정 가능, 바뀐 값만 되돌려 씀)
+struct ConstraintBatch
+{
+    int first = 0;
+    float time = 0.0f;
+    float dt = 0.0f;
+    std::span<glm::vec3> position;
+    std::span<const glm::vec3> velocity;
+    std::span<const std::uint8_t> pinned;
+};
+
+class ForceField
+{
+public:
+    virtual ~ForceField() = default;
+    virtual void apply(const ForceBatch& batch) = 0;
+};
+
+class ConstraintHook
+{
+public:
+    virtual ~ConstraintHook() = default;
+    virtual void project(const ConstraintBatch& batch) = 0;
+};
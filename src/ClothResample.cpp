@@ -0,0 +1,120 @@
+﻿#include "Cloth.h"
+#include <algorithm>
+#include <cmath>
+
+// 격자 해상도 변경: 현재 변형 상태(위치, 스텝당 이동량, 휴지 위치)를 새 격자로 쌍선형 보간해 옮김
+// 물리적 폭은 유지 (새 간격 = 옛 간격 * (옛 가로 - 1) / (새 가로 - 1)), 핀은 가장 가까운 새 정점으로 옮겨 원래 위치에 고정
+// 중력 워밍업은 다시 하지 않음 (frameCount 유지). 메시 천이나 찢어진 천은 격자가 아니므로 false
+template<class Real, class SolveReal>
+bool BasicCloth<Real, SolveReal>::resampleGrid(int newWidth, int newHeight)
+{
+    const int oldW = numWidth, oldH = numHeight;
+    if (!gridTopology || newWidth < 2 || newHeight < 2 || oldW < 2 || oldH < 2
+        || particles.size() != static_cast<size_t>(oldW) * oldH)
+        return false;
+    if (newWidth == oldW && newHeight == oldH) return true;
+
+    // 옛 상태 보관
+    std::vector<Vec3> oldPos(particles.size()), oldStep(particles.size()), oldRest(particles.size());
+    for (size_t i = 0; i < particles.size(); i++)
+    {
+        oldPos[i] = particles[i].pos;
+        oldStep[i] = particles[i].pos - particles[i].prevPos;
+        oldRest[i] = particles[i].restPos;
+    }
+    std::vector<int> oldPins;
+    for (size_t i = 0; i < particles.size(); i++)
+        if (particles[i].isFixed) oldPins.push_back(static_cast<int>(i));
+    const std::vector<int> oldAnchors = pinAnchors;
+
+    numWidth = newWidth;
+    numHeight = newHeight;
+    spacing = spacing * static_cast<float>(oldW - 1) / static_cast<float>(newWidth - 1);
+    initParticles();
+    initSprings();
+    buildIndices(numWidth, numHeight);
+
+    // 새 정점 (x, y)를 옛 격자 좌표로 옮겨 네 이웃을 보간
+    const Real sx = Real(oldW - 1) / Real(newWidth - 1);
+    const Real sy = Real(oldH - 1) / Real(newHeight - 1);
+    auto sample = [&](const std::vector<Vec3>& src, Real gx, Real gy) {
+        const int x0 = std::min(static_cast<int>(gx), oldW - 2);
+        const int y0 = std::min(static_cast<int>(gy), oldH - 2);
+        const Real fx = gx - Real(x0), fy = gy - Real(y0);
+        const Vec3& a = src[y0 * oldW + x0];
+        const Vec3& b = src[y0 * oldW + x0 + 1];
+        const Vec3& c = src[(y0 + 1) * oldW + x0];
+        const Vec3& d = src[(y0 + 1) * oldW + x0 + 1];
+        return (a * (Real(1) - fx) + b * fx) * (Real(1) - fy) + (c * (Real(1) - fx) + d * fx) * fy;
+    };
+    for (int y = 0; y < newHeight; y++)
+    {
+        for (int x = 0; x < newWidth; x++)
+        {
+            const Real gx = Real(x) * sx, gy = Real(y) * sy;
+            Particle& p = particles[getIndex(x, y)];
+            p.pos = sample(oldPos, gx, gy);
+            p.prevPos = p.pos - sample(oldStep, gx, gy);
+            p.restPos = sample(oldRest, gx, gy);
+        }
+    }
+
+    // 옛 정점 번호 -> 가장 가까운 새 정점 번호
+    auto mapIndex = [&](int oldIdx) {
+        const int ox = oldIdx % oldW, oy = oldIdx / oldW;
+        const int nx = static_cast<int>(std::lround(ox * (newWidth - 1) / static_cast<double>(oldW - 1)));
+        const int ny = static_cast<int>(std::lround(oy * (newHeight - 1) / static_cast<double>(oldH - 1)));
+        return getIndex(nx, ny);
+    };
+    // 줄일 때는 옛 핀 여러 개가 같은 새 정점에 모일 수 있으므로 새 정점에 가장 가까운 옛 핀을 고름 (옛 격자 단위 거리)
+    std::vector<int> pinSource(particles.size(), -1);
+    std::vector<Real> pinDist2(particles.size(), Real(0));
+    for (int idx : oldPins)
+    {
+        const int n = mapIndex(idx);
+        const Real dx = Real(idx % oldW) - Real(n % newWidth) * sx;
+        const Real dy = Real(idx / oldW) - Real(n / newWidth) * sy;
+        const Real d2 = dx * dx + dy * dy;
+        if (pinSource[n] < 0 || d2 < pinDist2[n])
+        {
+            pinSource[n] = idx;
+            pinDist2[n] = d2;
+        }
+    }
+    clearAllFixed();
+    for (int n = 0; n < static_cast<int>(particles.size()); n++)
+    {
+        if (pinSource[n] < 0) continue;
+        // 보간된 이동량이 남으면 핀을 풀 때 튀므로 정지 상태로 고정
+        particles[n].pos = oldPos[pinSource[n]];
+        particles[n].prevPos = particles[n].pos;
+        setParticleFixed(n, true);
+    }
+    pinAnchors.clear();
+    for (int idx : oldAnchors)
+        pinAnchors.push_back(mapIndex(idx));
+    corners = { getIndex(0, 0), getIndex(numWidth - 1, 0),
+        getIndex(0, numHeight - 1), getIndex(numWidth - 1, numHeight - 1) };
+
+    // 토폴로지에 딸린 캐시 초기화 (적응 반복/시간 간격 상태는 유지)
+    tearTopologyReady = false;
+    bvhTopologyDirty = true;
+    springColorsDirty = true;
+    contactQueryPos.clear();
+    cachedContacts.clear();
+    localSeeds.clear();
+    positionVersion++;
+    computeNormals();
+
+    if (vao)
+    {
+        destroyGL();
+        initGL();
+    }
+    return true;
+}
+
+#define CLOTH_INSTANTIATE(R, S) \
+    template bool BasicCloth<R, S>::resampleGrid(int, int);
+CLOTH_PRECISIONS(CLOTH_INSTANTIATE)
+#undef CLOTH_INSTANTIATE
@@ -0,0 +1,196 @@
+﻿#include "Cloth.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+
+namespace
+{
+    const int kMaxSpringColors = 64;
+    const int kUnreached = INT_MAX / 2;
+}
+
+// 변형률 제한 순서 구성
+// 1) 고정점에서 스프링 그래프 BFS 깊이 계산
+// 2) 스프링을 (얕은 쪽 깊이, 같은 깊이끼리 먼저) 순으로 묶고, 깊이가 다르면 먼 쪽 끝점만 움직이도록 표시
+// 3) 묶음 안에서 움직이는 끝점을 공유하지 않도록 탐욕적 색칠 (64색을 넘으면 직렬 묶음)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::buildSpringColors()
+{
+    const int n = static_cast<int>(particles.size());
+    const int numSprings = static_cast<int>(springs.size());
+
+    // 정점 -> 스프링 CSR
+    std::vector<int> adjStart(n + 1, 0);
+    for (const Spring& s : springs)
+    {
+        adjStart[s.p1 + 1]++;
+        adjStart[s.p2 + 1]++;
+    }
+    for (int i = 0; i < n; i++) adjStart[i + 1] += adjStart[i];
+    std::vector<int> adj(adjStart[n]);
+    {
+        std::vector<int> cursor(adjStart.begin(), adjStart.end() - 1);
+        for (int i = 0; i < numSprings; i++)
+        {
+            adj[cursor[springs[i].p1]++] = i;
+            adj[cursor[springs[i].p2]++] = i;
+        }
+    }
+
+    std::vector<int> depth(n, kUnreached);
+    std::vector<int> queue;
+    queue.reserve(n);
+    for (int i = 0; i < n; i++)
+    {
+        if (particles[i].isFixed) { depth[i] = 0; queue.push_back(i); }
+    }
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        const int v = queue[head];
+        for (int k = adjStart[v]; k < adjStart[v + 1]; k++)
+        {
+            const Spring& s = springs[adj[k]];
+            const int w = (s.p1 == v) ? s.p2 : s.p1;
+            if (depth[w] != kUnreached) continue;
+            depth[w] = depth[v] + 1;
+            queue.push_back(w);
+        }
+    }
+    const int maxDepth = queue.empty() ? 0 : depth[queue.back()];
+
+    // 묶음 키: 깊이 L에서 같은 깊이 스프링(2L) -> 바깥쪽 스프링(2L+1), 핀과 이어지지 않은 스프링은 마지막
+    auto sideOf = [&](const Spring& s) -> unsigned char {
+        return (depth[s.p1] < depth[s.p2]) ? 2 : (depth[s.p2] < depth[s.p1] ? 1 : 0);
+    };
+    const int numKeys = 2 * (maxDepth + 1) + 1;
+    std::vector<int> key(numSprings);
+    std::vector<int> keyStart(numKeys + 1, 0);
+    for (int i = 0; i < numSprings; i++)
+    {
+        const int level = std::min(depth[springs[i].p1], depth[springs[i].p2]);
+        key[i] = (level == kUnreached) ? numKeys - 1 : 2 * level + (sideOf(springs[i]) != 0 ? 1 : 0);
+        keyStart[key[i] + 1]++;
+    }
+    for (int k = 0; k < numKeys; k++) keyStart[k + 1] += keyStart[k];
+    std::vector<int> byKey(numSprings);
+    {
+        std::vector<int> cursor(keyStart.begin(), keyStart.end() - 1);
+        for (int i = 0; i < numSprings; i++) byKey[cursor[key[i]]++] = i;
+    }
+
+    springColorOrder.clear();
+    springColorOrder.reserve(numSprings);
+    springLimitSide.clear();
+    springLimitSide.reserve(numSprings);
+    springColorStart.assign(1, 0);
+    springBatchSerial.clear();
+
+    std::vector<std::uint64_t> used(n, 0);
+    std::vector<int> color;
+    for (int k = 0; k < numKeys; k++)
+    {
+        const int begin = keyStart[k], end = keyStart[k + 1];
+        if (begin == end) continue;
+
+        // 쓰는 끝점만 충돌로 봄 (핀 쪽 끝점은 앞 묶음에서 이미 끝났고 이 묶음에서는 읽기만 함)
+        color.assign(end - begin, 0);
+        int count[kMaxSpringColors + 1] = {};
+        for (int j = begin; j < end; j++)
+        {
+            const Spring& s = springs[byKey[j]];
+            const unsigned char side = sideOf(s);
+            std::uint64_t busy = (side != 2 ? used[s.p1] : 0) | (side != 1 ? used[s.p2] : 0);
+            int c = kMaxSpringColors;
+            if (~busy != 0)
+            {
+                c = 0;
+                while (busy & (std::uint64_t(1) << c)) c++;
+                if (side != 2) used[s.p1] |= std::uint64_t(1) << c;
+                if (side != 1) used[s.p2] |= std::uint64_t(1) << c;
+            }
+            color[j - begin] = c;
+            count[c]++;
+        }
+        for (int j = begin; j < end; j++)
+        {
+            used[springs[byKey[j]].p1] = 0;
+            used[springs[byKey[j]].p2] = 0;
+        }
+
+        for (int c = 0; c <= kMaxSpringColors; c++)
+        {
+            if (count[c] == 0) continue;
+            for (int j = begin; j < end; j++)
+            {
+                if (color[j - begin] != c) continue;
+                springColorOrder.push_back(byKey[j]);
+                springLimitSide.push_back(sideOf(springs[byKey[j]]));
+            }
+            springColorStart.push_back(static_cast<int>(springColorOrder.size()));
+            springBatchSerial.push_back(c == kMaxSpringColors ? 1 : 0);
+        }
+    }
+
+    springColorsDirty = false;
+}
+
+// 스프링 길이를 [1-e, 1+e] * restLength로 자르는 한 번의 순회 (묶음별 병렬)
+// 고정점이나 핀에 더 가까운 끝점은 움직이지 않고 반대쪽이 전부 이동
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::limitStrain()
+{
+    if (springColorsDirty) buildSpringColors();
+    using SolveVec3 = glm::vec<3, SolveReal>;
+
+    auto clampRange = [&](int begin, int end) {
+        for (int k = begin; k < end; k++)
+        {
+            const Spring& s = springs[springColorOrder[k]];
+            const float eps = strainLimit[static_cast<int>(s.type)];
+            if (eps <= 0.0f) continue;
+
+            Particle& p1 = particles[s.p1];
+            Particle& p2 = particles[s.p2];
+            SolveVec3 delta(p2.pos - p1.pos);
+            SolveReal dist = glm::length(delta);
+            if (dist < SolveReal(1e-8f)) continue;
+
+            const SolveReal rest = s.restLength;
+            SolveReal target = std::clamp(dist, rest * SolveReal(1.0f - eps), rest * SolveReal(1.0f + eps));
+            if (target == dist) continue;
+
+            const unsigned char side = springLimitSide[k];
+            SolveReal w1 = (p1.isFixed || side == 2) ? SolveReal(0) : SolveReal(1);
+            SolveReal w2 = (p2.isFixed || side == 1) ? SolveReal(0) : SolveReal(1);
+            SolveReal wSum = w1 + w2;
+            if (wSum == SolveReal(0)) continue;
+
+            SolveVec3 correction = delta * ((dist - target) / (dist * wSum));
+            p1.pos += Vec3(correction * w1);
+            p2.pos -= Vec3(correction * w2);
+        }
+    };
+
+    const int numBatches = static_cast<int>(springBatchSerial.size());
+    for (int b = 0; b < numBatches; b++)
+    {
+        const int base = springColorStart[b];
+        const int count = springColorStart[b + 1] - base;
+        if (springBatchSerial[b])
+        {
+            clampRange(base, base + count);
+            continue;
+        }
+        parallelFor(count, [&](int begin, int end) {
+            clampRange(base + begin, base + end);
+        }, BasicCloth::kParallelGrain);
+    }
+}
+
+#define CLOTH_INSTANTIATE(R, S) \
+    template void BasicCloth<R, S>::buildSpringColors(); \
+    template void BasicCloth<R, S>::limitStrain();
+CLOTH_PRECISIONS(CLOTH_INSTANTIATE)
+#undef CLOTH_INSTANTIATE
@@ -0,0 +1,378 @@
+﻿#include "ClothStrips.h"
+#include "Cloth.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+#ifdef __linux__
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+namespace
+{
+    const int kMinOverlapRows = 2;    // 굽힘 스프링이 2행을 건너므로
+    const int kRingSlots = 4;         // 이웃보다 최대 3번 앞서 보낼 수 있음
+    const int kSpinBeforeYield = 256;
+    const int kMaxStrips = 256;
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "프로세스 간 공유에 lock-free 원자 변수 필요");
+
+    // 캐시 라인 하나씩 차지하는 카운터 (쓰는 쪽 프로세스가 서로 다름)
+    struct alignas(64) SharedCounter
+    {
+        std::atomic<std::uint64_t> value{ 0 };
+    };
+
+    // 단일 생산자/단일 소비자 링 (written: 보낸 메시지 수, consumed: 읽은 메시지 수)
+    struct RingHeader
+    {
+        SharedCounter written;
+        SharedCounter consumed;
+    };
+
+    struct Control
+    {
+        SharedCounter abort;
+        SharedCounter release;             // 조정자가 다 읽은 프레임 수
+        SharedCounter frameDone[kMaxStrips]; // 띠별 모은 버퍼에 쓴 프레임 수
+    };
+
+    // 공유 메모리 배치: Control | 링 헤더 (경계마다 아래/위 2개) | 링 슬롯 | 모은 위치
+    struct SharedLayout
+    {
+        size_t ringOffset = 0;
+        size_t slotOffset = 0;
+        size_t positionOffset = 0;
+        size_t total = 0;
+        size_t haloFloats = 0;
+        int rings = 0;
+
+        SharedLayout(const StripParams& p)
+        {
+            auto align = [](size_t v) { return (v + 63) & ~size_t(63); };
+            haloFloats = static_cast<size_t>(p.overlapRows) * p.width * 3;
+            rings = 2 * (p.strips - 1);
+            ringOffset = align(sizeof(Control));
+            slotOffset = align(ringOffset + sizeof(RingHeader) * rings);
+            positionOffset = align(slotOffset + sizeof(float) * haloFloats * kRingSlots * rings);
+            total = positionOffset + sizeof(glm::vec3) * static_cast<size_t>(p.width) * p.height;
+        }
+    };
+
+    // 링 번호: 경계 b에서 아래 방향(b -> b+1)은 2b, 위 방향(b+1 -> b)은 2b+1
+    struct HaloChannel
+    {
+        RingHeader* header = nullptr;
+        float* slots = nullptr;
+        size_t floats = 0;
+        std::uint64_t next = 0;            // 보낼/받을 다음 메시지 번호 (이 프로세스 쪽)
+    };
+
+    template<class Pred>
+    bool waitFor(const Control* ctl, Pred ready)
+    {
+        for (int spin = 0; !ready(); spin++)
+        {
+            if (ctl->abort.value.load(std::memory_order_acquire)) return false;
+            if (spin >= kSpinBeforeYield) sched_yield();
+        }
+        return true;
+    }
+
+    bool sendHalo(const Control* ctl, HaloChannel& ch, const glm::vec3* rows)
+    {
+        const std::uint64_t seq = ch.next;
+        if (!waitFor(ctl, [&] { return seq - ch.header->consumed.value.load(std::memory_order_acquire) < kRingSlots; }))
+            return false;
+        std::memcpy(ch.slots + (seq % kRingSlots) * ch.floats, rows, ch.floats * sizeof(float));
+        ch.header->written.value.store(seq + 1, std::memory_order_release);
+        ch.next++;
+        return true;
+    }
+
+    bool receiveHalo(const Control* ctl, HaloChannel& ch, glm::vec3* rows)
+    {
+        const std::uint64_t seq = ch.next;
+        if (!waitFor(ctl, [&] { return ch.header->written.value.load(std::memory_order_acquire) > seq; }))
+            return false;
+        std::memcpy(static_cast<void*>(rows), ch.slots + (seq % kRingSlots) * ch.floats, ch.floats * sizeof(float));
+        ch.header->consumed.value.store(seq + 1, std::memory_order_release);
+        ch.next++;
+        return true;
+    }
+
+    // 띠 하나의 시뮬레이션 (자식 프로세스에서 실행)
+    // 행 [rowBegin, rowEnd)를 소유하고 위아래 overlapRows행(할로)은 이웃에게 받음
+    // 파티클/스프링 생성과 통합/순회는 행 구간으로 만든 Cloth가 하고, 여기서는 할로 교환과 순서만 맞춤
+    // 할로 안의 스프링까지 이 띠에서 같이 풀고(겹침 영역은 양쪽 띠가 중복 계산) 교환 때 할로를 이웃 값으로 덮어씀
+    // 경계를 건너는 스프링만 풀면 경계가 한 반복씩 늦어 천이 눈에 띄게 늘어나므로 겹침을 둠
+    class StripWorker
+    {
+    public:
+        StripWorker(const StripParams& p, int strip, Control* ctl, char* shared, const SharedLayout& layout)
+            : params(p), strip(strip), ctl(ctl),
+            rowBegin(static_cast<int>(static_cast<long long>(p.height) * strip / p.strips)),
+            rowEnd(static_cast<int>(static_cast<long long>(p.height) * (strip + 1) / p.strips)),
+            localBegin(std::max(0, rowBegin - p.overlapRows)),
+            localEnd(std::min(p.height, rowEnd + p.overlapRows)),
+            cloth(p.width, localEnd - localBegin, p.spacing, localBegin, p.height)
+        {
+            auto channel = [&](int ring) {
+                HaloChannel ch;
+                ch.header = reinterpret_cast<RingHeader*>(shared + layout.ringOffset) + ring;
+                ch.slots = reinterpret_cast<float*>(shared + layout.slotOffset) + layout.haloFloats * kRingSlots * ring;
+                ch.floats = layout.haloFloats;
+                return ch;
+            };
+            hasUp = strip > 0;
+            hasDown = strip < p.strips - 1;
+            if (hasUp) { sendUp = channel(2 * (strip - 1) + 1); recvUp = channel(2 * (strip - 1)); }
+            if (hasDown) { sendDown = channel(2 * strip); recvDown = channel(2 * strip + 1); }
+            gathered = reinterpret_cast<glm::vec3*>(shared + layout.positionOffset);
+            halo.resize(static_cast<size_t>(p.overlapRows) * p.width);
+        }
+
+        bool run(int frames)
+        {
+            const float dt = params.frameTime;
+            const int localRows = localEnd - localBegin;
+            for (int f = 0; f < frames; f++)
+            {
+                cloth.integrateRows(rowBegin - localBegin, rowEnd - localBegin, dt);
+                if (!exchange()) return false;
+                for (int it = 0; it < params.iterations; it++)
+                {
+                    cloth.solveRows(0, localRows);
+                    if (!exchange()) return false;
+                }
+                cloth.finishRowsStep(dt);
+
+                // 조정자가 이전 프레임을 다 읽은 뒤에 씀
+                if (!waitFor(ctl, [&] { return ctl->release.value.load(std::memory_order_acquire) >= static_cast<std::uint64_t>(f); }))
+                    return false;
+                cloth.copyRowPositions(rowBegin - localBegin, rowEnd - rowBegin, gathered + static_cast<size_t>(rowBegin) * params.width);
+                ctl->frameDone[strip].value.store(f + 1, std::memory_order_release);
+            }
+            return true;
+        }
+
+    private:
+        const StripParams& params;
+        const int strip;
+        Control* ctl;
+        const int rowBegin, rowEnd;
+        const int localBegin, localEnd;
+        Cloth cloth;
+        bool hasUp = false, hasDown = false;
+        HaloChannel sendUp, recvUp, sendDown, recvDown;
+        glm::vec3* gathered = nullptr;
+        std::vector<glm::vec3> halo;
+
+        // 경계 행을 이웃에게 보내고 이웃의 경계 행을 할로로 받음
+        bool exchange()
+        {
+            const int overlap = params.overlapRows;
+            if (hasUp)
+            {
+                cloth.copyRowPositions(rowBegin - localBegin, overlap, halo.data());
+                if (!sendHalo(ctl, sendUp, halo.data())) return false;
+            }
+            if (hasDown)
+            {
+                cloth.copyRowPositions(rowEnd - overlap - localBegin, overlap, halo.data());
+                if (!sendHalo(ctl, sendDown, halo.data())) return false;
+            }
+            if (hasUp)
+            {
+                if (!receiveHalo(ctl, recvUp, halo.data())) return false;
+                cloth.setRowPositions(0, overlap, halo.data());
+            }
+            if (hasDown)
+            {
+                if (!receiveHalo(ctl, recvDown, halo.data())) return false;
+                cloth.setRowPositions(rowEnd - localBegin, overlap, halo.data());
+            }
+            return true;
+        }
+    };
+
+    // 자식 프로세스가 하나라도 비정상 종료했으면 true
+    bool workerFailed(const std::vector<pid_t>& pids)
+    {
+        for (pid_t pid : pids)
+        {
+            int status = 0;
+            if (waitpid(pid, &status, WNOHANG) == pid && !(WIFEXITED(status) && WEXITSTATUS(status) == 0))
+                return true;
+        }
+        return false;
+    }
+}
+
+bool runStripSimulation(const StripParams& params, int frames, const StripFrameFn& onFrame)
+{
+    if (params.width < 3 || params.strips < 1 || params.strips > kMaxStrips
+        || params.overlapRows < kMinOverlapRows || params.height < params.strips * params.overlapRows
+        || params.iterations < 1)
+    {
+        std::fprintf(stderr, "strip decomposition: invalid grid %dx%d for %d strips (overlap %d rows)\n",
+            params.width, params.height, params.strips, params.overlapRows);
+        return false;
+    }
+
+    const SharedLayout layout(params);
+    void* mem = mmap(nullptr, layout.total, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+    {
+        std::perror("strip decomposition: mmap");
+        return false;
+    }
+    char* shared = static_cast<char*>(mem);
+    Control* ctl = new (shared) Control();
+    RingHeader* rings = reinterpret_cast<RingHeader*>(shared + layout.ringOffset);
+    for (int r = 0; r < layout.rings; r++) new (rings + r) RingHeader();
+    const glm::vec3* gathered = reinterpret_cast<const glm::vec3*>(shared + layout.positionOffset);
+
+    // 자식에는 풀 작업자 스레드가 없으므로 풀을 fork 전에 만들어 두고 자식에서는 직렬로만 씀
+    // 자식은 자기 띠 배열만 새로 할당 (CPU 고정 후 first-touch)
+    ThreadPool::instance();
+    const long cpus = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    std::vector<pid_t> pids;
+    bool ok = true;
+    for (int s = 0; s < params.strips && ok; s++)
+    {
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            std::perror("strip decomposition: fork");
+            ok = false;
+            break;
+        }
+        if (pid == 0)
+        {
+            if (params.pinWorkers)
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(static_cast<int>(s % cpus), &set);
+                sched_setaffinity(0, sizeof(set), &set);
+            }
+            ThreadPool::setSerialThread(true);
+            bool done = false;
+            {
+                StripWorker worker(params, s, ctl, shared, layout);
+                done = worker.run(frames);
+            }
+            _exit(done ? 0 : 1);
+        }
+        pids.push_back(pid);
+    }
+
+    for (int f = 0; f < frames && ok; f++)
+    {
+        for (int s = 0; s < params.strips && ok; s++)
+        {
+            for (int spin = 0; ctl->frameDone[s].value.load(std::memory_order_acquire) <= static_cast<std::uint64_t>(f); spin++)
+            {
+                if (spin >= kSpinBeforeYield)
+                {
+                    if (workerFailed(pids)) { ok = false; break; }
+                    sched_yield();
+                }
+            }
+        }
+        if (ok && onFrame && !onFrame(f, gathered)) ok = false;
+        ctl->release.value.store(f + 1, std::memory_order_release);
+    }
+
+    if (!ok) ctl->abort.value.store(1, std::memory_order_release);
+    for (pid_t pid : pids)
+    {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!(WIFEXITED(status) && WEXITSTATUS(status) == 0) && ok)
+        {
+            std::fprintf(stderr, "strip decomposition: worker %d failed\n", static_cast<int>(pid));
+            ok = false;
+        }
+    }
+    munmap(mem, layout.total);
+    return ok;
+}
+#else
+bool runStripSimulation(const StripParams&, int, const StripFrameFn&)
+{
+    std::fprintf(stderr, "strip decomposition requires Linux\n");
+    return false;
+}
+#endif
+
+namespace
+{
+    // 위치와 격자 삼각형만 담은 OBJ (Cloth::buildIndices와 같은 감김 순서)
+    bool writeGridOBJ(const std::string& path, const std::vector<glm::vec3>& positions, int w, int h)
+    {
+        std::ofstream obj(path, std::ios::out | std::ios::trunc);
+        if (!obj) return false;
+        obj << std::fixed << std::setprecision(6);
+        for (const glm::vec3& p : positions)
+            obj << "v " << p.x << ' ' << p.y << ' ' << p.z << '\n';
+        for (int y = 0; y < h - 1; y++)
+        {
+            for (int x = 0; x < w - 1; x++)
+            {
+                const long long i0 = static_cast<long long>(y) * w + x + 1;
+                const long long i1 = i0 + 1, i2 = i0 + w, i3 = i2 + 1;
+                obj << "f " << i0 << ' ' << i1 << ' ' << i2 << '\n';
+                obj << "f " << i1 << ' ' << i3 << ' ' << i2 << '\n';
+            }
+        }
+        return static_cast<bool>(obj);
+    }
+}
+
+int runStripExport(const StripParams& params, int frames, const std::string& objPath)
+{
+    std::printf("strip decomposition: %dx%d grid, %d strips, %d frames\n", params.width, params.height, params.strips, frames);
+
+    std::vector<glm::vec3> last;
+    auto t0 = std::chrono::steady_clock::now();
+    auto prev = t0;
+    const bool ok = runStripSimulation(params, frames, [&](int frame, const glm::vec3* positions) {
+        auto now = std::chrono::steady_clock::now();
+        if (frame % 60 == 0 || frame == frames - 1)
+            std::printf("  frame %4d  %8.2f ms\n", frame, std::chrono::duration<double, std::milli>(now - prev).count());
+        prev = now;
+        if (frame == frames - 1 && !objPath.empty())
+            last.assign(positions, positions + static_cast<size_t>(params.width) * params.height);
+        return true;
+    });
+    if (!ok) return 1;
+
+    const double total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("  %.2f ms/frame\n", total / std::max(1, frames));
+
+    if (!objPath.empty())
+    {
+        if (!writeGridOBJ(objPath, last, params.width, params.height))
+        {
+            std::fprintf(stderr, "failed to write %s\n", objPath.c_str());
+            return 1;
+        }
+        std::printf("  wrote %s\n", objPath.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+﻿#pragma once
+
+#include <functional>
+#include <string>
+#include <glm/glm.hpp>
+
+// 다중 프로세스 띠 분할 (수천만 파티클 오프라인 장면용, Linux 한 대에서 실행)
+// 격자를 가로 띠로 나눠 띠마다 자식 프로세스 하나가 맡고,
+// 띠 경계의 겹침 행은 적분 후와 제약 반복마다 공유 메모리 링 버퍼로 이웃과 교환
+// 조정자(부모 프로세스)는 프레임마다 모든 띠의 위치를 한 버퍼로 모아 콜백에 넘김
+struct StripParams
+{
+    int width = 0;
+    int height = 0;
+    float spacing = 0.02f;
+    int strips = 2;
+    int iterations = 8;                 // 프레임당 제약 반복 (모든 띠가 같은 횟수)
+    int overlapRows = 8;                // 이웃 띠와 겹쳐 중복으로 푸는 행 수 (최소 2, 띠 높이 이하)
+    float frameTime = 1.0f / 60.0f;
+    bool pinWorkers = true;             // 띠 프로세스를 CPU에 고정 (NUMA 노드별 first-touch)
+};
+
+// positions: width * height개 (행 우선, Cloth 격자와 같은 순서), 다음 프레임을 모으기 전까지만 유효
+// false를 돌려주면 시뮬레이션 중단
+using StripFrameFn = std::function<bool(int frame, const glm::vec3* positions)>;
+
+// 실패(Linux가 아님, 잘못된 분할, 자식 프로세스 비정상 종료) 시 false
+bool runStripSimulation(const StripParams& params, int frames, const StripFrameFn& onFrame);
+
+// 창 없이 실행해 프레임당 시간을 출력하고, objPath가 있으면 마지막 프레임을 OBJ로 저장
+int runStripExport(const StripParams& params, int frames, const std::string& objPath);
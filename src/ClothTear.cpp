@@ -0,0 +1,294 @@
+﻿#include "Cloth.h"
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+    // 벡터에서 값 하나 제거 (순서 무시)
+    void eraseValue(std::vector<int>& v, int value)
+    {
+        auto it = std::find(v.begin(), v.end(), value);
+        if (it == v.end()) return;
+        *it = v.back();
+        v.pop_back();
+    }
+
+    void replaceValue(std::vector<int>& v, int from, int to)
+    {
+        auto it = std::find(v.begin(), v.end(), from);
+        if (it != v.end()) *it = to;
+    }
+}
+
+// 정점-삼각형/정점-스프링 인접 정보와 에지별 스프링 개수 구성, 원본 토폴로지 보관
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::buildTearTopology()
+{
+    const size_t n = particles.size();
+    vertexTris.assign(n, {});
+    vertexSprings.assign(n, {});
+    edgeSpringCount.clear();
+    edgeSpringCount.reserve(indices.size());
+
+    for (size_t t = 0; t * 3 + 2 < indices.size(); t++)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            unsigned int a = indices[t * 3 + k];
+            unsigned int b = indices[t * 3 + (k + 1) % 3];
+            vertexTris[a].push_back(static_cast<int>(t));
+            edgeSpringCount.emplace(edgeKey(a, b), 0);
+        }
+    }
+
+    for (int i = 0; i < static_cast<int>(springs.size()); i++)
+    {
+        const Spring& s = springs[i];
+        vertexSprings[s.p1].push_back(i);
+        vertexSprings[s.p2].push_back(i);
+        auto it = edgeSpringCount.find(edgeKey(s.p1, s.p2));
+        if (it != edgeSpringCount.end()) it->second++;
+    }
+
+    restParticleCount = n;
+    restSprings = springs;
+    restIndices = indices;
+    tearTopologyReady = true;
+}
+
+// 임계 변형률을 넘은 스프링을 끊고, 스프링이 모두 끊긴 삼각형 에지의 양 끝 정점을 분리
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::processTears()
+{
+    if (!tearTopologyReady) buildTearTopology();
+
+    const float limit = 1.0f + tearStrain;
+    std::vector<int> splitQueue;
+
+    for (int i = 0; i < static_cast<int>(springs.size());)
+    {
+        const Spring& s = springs[i];
+        float dist = static_cast<float>(glm::length(particles[s.p2].pos - particles[s.p1].pos));
+        if (dist <= s.restLength * limit)
+        {
+            i++;
+            continue;
+        }
+
+        int a = s.p1, b = s.p2;
+        removeSpring(i); // 뒤쪽 스프링이 i로 옮겨지므로 i는 그대로
+
+        auto it = edgeSpringCount.find(edgeKey(a, b));
+        if (it != edgeSpringCount.end() && --it->second == 0)
+        {
+            splitQueue.push_back(a);
+            splitQueue.push_back(b);
+        }
+    }
+
+    for (int v : splitQueue)
+        splitVertex(v);
+
+    if (!splitQueue.empty()) positionVersion++;
+}
+
+// 스프링 제거 (종류별 묶음 유지: 같은 종류의 마지막 스프링을 빈자리로 옮기고,
+// 뒤 종류들은 각자 마지막 스프링을 앞으로 당겨 빈자리를 배열 끝까지 밀어냄)
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::removeSpring(int si)
+{
+    springColorsDirty = true;
+    localAdjDirty = true;
+    solveColorsDirty = true;
+    eraseValue(vertexSprings[springs[si].p1], si);
+    eraseValue(vertexSprings[springs[si].p2], si);
+
+    const int cls = static_cast<int>(springs[si].type);
+    int hole = si;
+    for (int c = cls; c < static_cast<int>(SpringType::Count); c++)
+    {
+        const int last = springClassStart[c + 1] - 1;
+        if (last != hole)
+        {
+            springs[hole] = springs[last];
+            replaceValue(vertexSprings[springs[hole].p1], last, hole);
+            replaceValue(vertexSprings[springs[hole].p2], last, hole);
+        }
+        hole = last;
+        springClassStart[c + 1]--;
+    }
+    springs.pop_back();
+}
+
+// 정점 v 주변 삼각형 팬을 끊기지 않은 에지로 묶고, 분리된 묶음마다 정점 복제
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::splitVertex(int v)
+{
+    const std::vector<int> fan = vertexTris[v];
+    const int k = static_cast<int>(fan.size());
+    if (k < 2) return;
+
+    std::vector<int> parent(k);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](int x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    };
+
+    auto triHas = [&](int t, unsigned int w) {
+        return indices[t * 3] == w || indices[t * 3 + 1] == w || indices[t * 3 + 2] == w;
+    };
+
+    for (int i = 0; i < k; i++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            unsigned int w = indices[fan[i] * 3 + c];
+            if (static_cast<int>(w) == v) continue;
+
+            auto it = edgeSpringCount.find(edgeKey(v, w));
+            if (it == edgeSpringCount.end() || it->second <= 0) continue; // 끊긴 에지
+
+            for (int j = i + 1; j < k; j++)
+            {
+                if (triHas(fan[j], w)) parent[find(j)] = find(i);
+            }
+        }
+    }
+
+    // 묶음별 삼각형 목록 (첫 묶음은 원래 정점 유지)
+    std::vector<int> compOf(k);
+    std::vector<int> roots;
+    for (int i = 0; i < k; i++)
+    {
+        int r = find(i);
+        auto it = std::find(roots.begin(), roots.end(), r);
+        compOf[i] = static_cast<int>(it - roots.begin());
+        if (it == roots.end()) roots.push_back(r);
+    }
+    const int numComps = static_cast<int>(roots.size());
+    if (numComps < 2) return;
+
+    std::vector<int> compVertex(numComps, v);
+    for (int c = 1; c < numComps; c++)
+    {
+        int nv = static_cast<int>(particles.size());
+        compVertex[c] = nv;
+
+        particles.push_back(particles[v]);
+        if (particles[v].isFixed) fixedCount++;
+        if (uvs.size() > static_cast<size_t>(v)) uvs.push_back(uvs[v]);
+        vertexTris.emplace_back();
+        vertexSprings.emplace_back();
+    }
+    localAdjDirty = true;
+    solveColorsDirty = true;
+
+    vertexTris[v].clear();
+    for (int i = 0; i < k; i++)
+    {
+        const int t = fan[i];
+        const int nv = compVertex[compOf[i]];
+        vertexTris[nv].push_back(t);
+        if (nv == v) continue;
+
+        for (int c = 0; c < 3; c++)
+        {
+            unsigned int& idx = indices[t * 3 + c];
+            if (static_cast<int>(idx) == v) idx = static_cast<unsigned int>(nv);
+        }
+        for (int c = 0; c < 3; c++)
+        {
+            unsigned int w = indices[t * 3 + c];
+            if (static_cast<int>(w) != nv) edgeSpringCount.emplace(edgeKey(nv, w), 0);
+        }
+        markIndicesDirty(t * 3, t * 3 + 3);
+    }
+
+    // v에 붙은 스프링을 상대 정점이 속한 묶음의 정점으로 옮김
+    const std::vector<int> attached = vertexSprings[v];
+    for (int si : attached)
+    {
+        Spring& s = springs[si];
+        const int other = (s.p1 == v) ? s.p2 : s.p1;
+
+        int target = -1;
+        for (int i = 0; i < k && target < 0; i++)
+        {
+            if (triHas(fan[i], other)) target = compOf[i];
+        }
+        if (target < 0)
+        {
+            // 팬에 없는 상대(굽힘 스프링 등)는 가장 가까운 삼각형의 묶음으로
+            float best = 1e30f;
+            for (int i = 0; i < k; i++)
+            {
+                const int t = fan[i];
+                Vec3 centroid = (particles[indices[t * 3]].pos + particles[indices[t * 3 + 1]].pos
+                    + particles[indices[t * 3 + 2]].pos) / Real(3);
+                float d = static_cast<float>(glm::length(centroid - particles[other].pos));
+                if (d < best) { best = d; target = compOf[i]; }
+            }
+        }
+
+        const int nv = compVertex[target];
+        if (nv == v) continue;
+
+        auto oldIt = edgeSpringCount.find(edgeKey(v, other));
+        if (oldIt != edgeSpringCount.end()) oldIt->second--;
+        auto newIt = edgeSpringCount.find(edgeKey(nv, other));
+        if (newIt != edgeSpringCount.end()) newIt->second++;
+
+        if (s.p1 == v) s.p1 = nv; else s.p2 = nv;
+        eraseValue(vertexSprings[v], si);
+        vertexSprings[nv].push_back(si);
+    }
+}
+
+// 찢어지기 전 토폴로지로 복원
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::restoreTopology()
+{
+    if (particles.size() == restParticleCount && springs.size() == restSprings.size())
+        return;
+
+    for (size_t i = restParticleCount; i < particles.size(); i++)
+    {
+        if (particles[i].isFixed) fixedCount--;
+    }
+    particles.erase(particles.begin() + restParticleCount, particles.end());
+    if (uvs.size() > restParticleCount) uvs.resize(restParticleCount);
+    springs = restSprings;
+    groupSpringsByClass();
+    springColorsDirty = true;
+    indices = restIndices;
+    markIndicesDirty(0, indices.size());
+    gpuUVCount = std::min(gpuUVCount, uvs.size());
+    positionVersion++;
+
+    tearTopologyReady = false;
+}
+
+// EBO 재업로드 범위 확장
+template<class Real, class SolveReal>
+void BasicCloth<Real, SolveReal>::markIndicesDirty(size_t begin, size_t end)
+{
+    if (indexDirtyEnd <= indexDirtyBegin)
+    {
+        indexDirtyBegin = begin;
+        indexDirtyEnd = end;
+        return;
+    }
+    indexDirtyBegin = std::min(indexDirtyBegin, begin);
+    indexDirtyEnd = std::max(indexDirtyEnd, end);
+}
+
+#define CLOTH_INSTANTIATE(R, S) \
+    template void BasicCloth<R, S>::buildTearTopology(); \
+    template void BasicCloth<R, S>::processTears(); \
+    template void BasicCloth<R, S>::removeSpring(int); \
+    template void BasicCloth<R, S>::splitVertex(int); \
+    template void BasicCloth<R, S>::restoreTopology(); \
+    template void BasicCloth<R, S>::markIndicesDirty(size_t, size_t);
+CLOTH_PRECISIONS(CLOTH_INSTANTIATE)
+#undef CLOTH_INSTANTIATE
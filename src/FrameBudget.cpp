@@ -0,0 +1,90 @@
+﻿#include "FrameBudget.h"
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+    // 서브스텝을 먼저 줄이고 (시뮬레이션이 실시간보다 느려질 뿐), 반복 수와 노멀 갱신은 그다음
+    const FrameBudget::Level kLevels[] = {
+        { 8, 0, 1 },
+        { 6, 16, 1 },
+        { 4, 12, 1 },
+        { 3, 10, 2 },
+        { 2, 8, 2 },
+        { 2, 6, 4 },
+        { 1, 4, 4 },
+        { 1, 2, 8 },
+    };
+}
+
+const float FrameBudget::kUpHeadroom = 0.7f;
+const int   FrameBudget::kDownFrames = 3;
+const int   FrameBudget::kUpFrames = 60;
+const int   FrameBudget::kMaxUpWait = 960;
+const float FrameBudget::kSmoothing = 0.2f;
+
+int FrameBudget::getLevelCount()
+{
+    return static_cast<int>(std::size(kLevels));
+}
+
+const FrameBudget::Level& FrameBudget::getLevel() const
+{
+    return kLevels[level];
+}
+
+void FrameBudget::reset()
+{
+    level = 0;
+    overFrames = underFrames = framesAtLevel = 0;
+    upWait = kUpFrames;
+    raised = false;
+    primed = false;
+    smoothed = Timing();
+}
+
+bool FrameBudget::update(const Timing& t)
+{
+    if (!primed)
+    {
+        smoothed = t;
+        primed = true;
+    }
+    else
+    {
+        smoothed.simMs += (t.simMs - smoothed.simMs) * kSmoothing;
+        smoothed.uploadMs += (t.uploadMs - smoothed.uploadMs) * kSmoothing;
+        smoothed.renderMs += (t.renderMs - smoothed.renderMs) * kSmoothing;
+    }
+
+    const float total = smoothed.total();
+    overFrames = (total > targetMs) ? overFrames + 1 : 0;
+    underFrames = (total < targetMs * kUpHeadroom) ? underFrames + 1 : 0;
+    framesAtLevel++;
+
+    // 올려서 온 단계가 충분히 버티면 대기 시간을 처음으로
+    if (raised && framesAtLevel >= kUpFrames)
+    {
+        upWait = kUpFrames;
+        raised = false;
+    }
+
+    int next = level;
+    if (overFrames >= kDownFrames && level + 1 < getLevelCount())
+    {
+        next = level + 1;
+        if (raised) upWait = std::min(upWait * 2, kMaxUpWait);
+    }
+    else if (underFrames >= upWait && level > 0)
+    {
+        next = level - 1;
+    }
+    if (next == level) return false;
+
+    // 단계를 바꾼 직후의 측정값은 이전 단계 것이므로 카운터를 비우고 다시 셈
+    raised = next < level;
+    level = next;
+    overFrames = underFrames = framesAtLevel = 0;
+    primed = false;
+    return true;
+}
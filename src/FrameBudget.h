@@ -0,0 +1,57 @@
+﻿#pragma once
+
+// 프레임 예산 제어기: 프레임마다 시뮬레이션/업로드/렌더 시간을 받아 품질 단계를 고름
+// 평활한 합이 예산을 kDownFrames 프레임 연속 넘으면 한 단계 낮추고,
+// 예산의 kUpHeadroom배 아래에 upWait 프레임 연속 머물러야 한 단계 올림
+// 올린 단계가 곧바로 예산을 넘기면 upWait를 두 배로 늘려 (최대 kMaxUpWait) 경계에서 오가지 않게 함
+class FrameBudget
+{
+public:
+    // 품질 단계 (0이 최고)
+    struct Level
+    {
+        int maxSubsteps;    // 프레임당 서브스텝 상한
+        int iterationCap;   // 스텝당 제약 반복 상한 (0이면 적응 반복 상한 그대로)
+        int normalInterval; // 노멀을 이 스텝 수마다 갱신
+    };
+
+    // 한 프레임 측정값 (ms)
+    struct Timing
+    {
+        float simMs = 0.0f;
+        float uploadMs = 0.0f;
+        float renderMs = 0.0f;
+        float total() const { return simMs + uploadMs + renderMs; }
+    };
+
+    static const float kUpHeadroom;
+    static const int   kDownFrames;
+    static const int   kUpFrames;
+    static const int   kMaxUpWait;
+    static const float kSmoothing; // 평활 계수 (새 측정값 비중)
+
+    void setTargetMs(float ms) { targetMs = ms; }
+    float getTargetMs() const { return targetMs; }
+
+    // 최고 단계부터 다시 시작
+    void reset();
+
+    // 이번 프레임 측정값 반영, 단계가 바뀌었으면 true
+    bool update(const Timing& t);
+
+    int getLevelIndex() const { return level; }
+    static int getLevelCount();
+    const Level& getLevel() const;
+    const Timing& getSmoothed() const { return smoothed; }
+
+private:
+    float targetMs = 16.6f;
+    int level = 0;
+    int overFrames = 0;
+    int underFrames = 0;
+    int framesAtLevel = 0;
+    int upWait = kUpFrames;
+    bool raised = false; // 현재 단계가 올려서 온 단계인지
+    bool primed = false;
+    Timing smoothed;
+};
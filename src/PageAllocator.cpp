@@ -0,0 +1,144 @@
+﻿#include "PageAllocator.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstdint>
+
+#ifdef __linux__
+#include <cstdio>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    PageAllocOptions g_options;
+    const size_t kSmallPageBytes = 4096;
+    const int kPlacementSamples = 64;
+
+    size_t roundUp(size_t v, size_t a) { return (v + a - 1) / a * a; }
+}
+
+void setPageAllocOptions(const PageAllocOptions& options) { g_options = options; }
+const PageAllocOptions& getPageAllocOptions() { return g_options; }
+
+#ifdef __linux__
+// 경로는 크기로만 정함 (옵션이 할당 후에 바뀌어도 해제 경로가 같도록)
+void* allocatePages(size_t bytes)
+{
+    if (bytes < kHugePageBytes)
+        return ::operator new(std::max<size_t>(bytes, 1));
+
+    // 2MB 정렬을 위해 한 페이지 더 잡고 앞뒤를 잘라냄
+    const size_t size = roundUp(bytes, kHugePageBytes);
+    void* raw = mmap(nullptr, size + kHugePageBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) throw std::bad_alloc();
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t aligned = roundUp(base, kHugePageBytes);
+    if (aligned > base) munmap(raw, aligned - base);
+    if (aligned + size < base + size + kHugePageBytes)
+        munmap(reinterpret_cast<void*>(aligned + size), base + size + kHugePageBytes - (aligned + size));
+    char* p = reinterpret_cast<char*>(aligned);
+
+    if (g_options.hugePages)
+        madvise(p, size, MADV_HUGEPAGE);
+
+    // 대용량 페이지 단위로 구간을 나눠 parallelFor와 같은 스레드 배정으로 처음 건드림
+    if (g_options.parallelFirstTouch)
+    {
+        const int units = static_cast<int>(size / kHugePageBytes);
+        parallelFor(units, [&](int begin, int end) {
+            for (size_t off = begin * kHugePageBytes; off < end * kHugePageBytes; off += kSmallPageBytes)
+                p[off] = 0;
+        });
+    }
+    return p;
+}
+
+void freePages(void* p, size_t bytes)
+{
+    if (!p) return;
+    if (bytes < kHugePageBytes)
+    {
+        ::operator delete(p);
+        return;
+    }
+    munmap(p, roundUp(bytes, kHugePageBytes));
+}
+
+namespace
+{
+    // p를 포함하는 매핑의 AnonHugePages (kB 단위 합)
+    size_t anonHugeBytes(const void* p, size_t bytes)
+    {
+        FILE* f = std::fopen("/proc/self/smaps", "r");
+        if (!f) return 0;
+        const std::uintptr_t lo = reinterpret_cast<std::uintptr_t>(p);
+        const std::uintptr_t hi = lo + bytes;
+        size_t total = 0;
+        bool inRange = false;
+        char line[512];
+        while (std::fgets(line, sizeof(line), f))
+        {
+            // 매핑 머리 줄 "start-end perms ..." 다음에 그 매핑의 항목 줄들이 옴
+            unsigned long start = 0, end = 0;
+            if (std::sscanf(line, "%lx-%lx ", &start, &end) == 2)
+            {
+                inRange = start < hi && end > lo;
+                continue;
+            }
+            size_t kb = 0;
+            if (inRange && std::sscanf(line, "AnonHugePages: %zu kB", &kb) == 1)
+                total += kb * 1024;
+        }
+        std::fclose(f);
+        return std::min(total, bytes);
+    }
+}
+
+PagePlacement queryPagePlacement(const void* p, size_t bytes)
+{
+    PagePlacement out;
+    out.bytes = bytes;
+    out.pageBacked = bytes >= kHugePageBytes;
+    if (!p || bytes == 0) return out;
+
+    // 표본 페이지의 NUMA 노드 (move_pages에 노드 배열 없이 넘기면 현재 위치만 돌려줌)
+    const size_t pages = (bytes + kSmallPageBytes - 1) / kSmallPageBytes;
+    const int samples = static_cast<int>(std::min<size_t>(pages, kPlacementSamples));
+    void* addrs[kPlacementSamples];
+    int status[kPlacementSamples];
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(p) & ~(kSmallPageBytes - 1);
+    for (int i = 0; i < samples; i++)
+        addrs[i] = reinterpret_cast<void*>(base + (pages * i / samples) * kSmallPageBytes);
+    if (syscall(SYS_move_pages, 0, static_cast<unsigned long>(samples), addrs, nullptr, status, 0) == 0)
+    {
+        for (int i = 0; i < samples; i++)
+        {
+            if (status[i] < 0) continue;
+            out.nodePages[std::min(status[i], kMaxPageNodes - 1)]++;
+            out.sampledPages++;
+        }
+    }
+
+    if (out.pageBacked) out.hugeBytes = anonHugeBytes(p, bytes);
+    return out;
+}
+#else
+void* allocatePages(size_t bytes)
+{
+    return ::operator new(std::max<size_t>(bytes, 1));
+}
+
+void freePages(void* p, size_t)
+{
+    ::operator delete(p);
+}
+
+PagePlacement queryPagePlacement(const void*, size_t bytes)
+{
+    PagePlacement out;
+    out.bytes = bytes;
+    return out;
+}
+#endif
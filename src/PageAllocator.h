@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// 큰 버퍼용 페이지 할당 (파티클/스프링/인덱스 버퍼)
+// kHugePageBytes 이상인 버퍼는 Linux에서 2MB 경계에 맞춰 mmap으로 새 페이지를 받고
+// madvise(MADV_HUGEPAGE)로 투명 대용량 페이지를 요청한 뒤, 스레드 풀 구간대로 나눠 각 작업자가 처음 건드림
+// (first-touch: 그 구간을 맡는 스레드의 NUMA 노드에 페이지가 놓임). 작은 버퍼와 다른 플랫폼은 operator new
+const size_t kHugePageBytes = 2 * 1024 * 1024;
+const int kMaxPageNodes = 8;
+
+struct PageAllocOptions
+{
+    bool hugePages = true;           // MADV_HUGEPAGE 요청
+    bool parallelFirstTouch = true;  // 작업자 스레드가 자기 구간 페이지를 처음 건드림
+};
+
+void setPageAllocOptions(const PageAllocOptions& options);
+const PageAllocOptions& getPageAllocOptions();
+
+void* allocatePages(size_t bytes);
+void freePages(void* p, size_t bytes);
+
+// 버퍼가 실제로 어디에 놓였는지 (표본 페이지 기준)
+struct PagePlacement
+{
+    size_t bytes = 0;
+    size_t hugeBytes = 0;                 // 대용량 페이지로 덮인 바이트 (/proc/self/smaps, 모르면 0)
+    bool pageBacked = false;              // 페이지 할당 경로를 탔는지
+    int sampledPages = 0;
+    int nodePages[kMaxPageNodes] = {};    // 표본 페이지의 노드별 개수 (노드를 알 수 없으면 모두 0)
+};
+PagePlacement queryPagePlacement(const void* p, size_t bytes);
+
+// std::vector용 할당자
+template<class T>
+class PageAllocator
+{
+public:
+    using value_type = T;
+
+    PageAllocator() = default;
+    template<class U> PageAllocator(const PageAllocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(allocatePages(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { freePages(p, n * sizeof(T)); }
+
+    template<class U> bool operator==(const PageAllocator<U>&) const { return true; }
+    template<class U> bool operator!=(const PageAllocator<U>&) const { return false; }
+};
+
+template<class T>
+using PageVector = std::vector<T, PageAllocator<T>>;
@@ -0,0 +1,114 @@
+﻿#include "Parallel.h"
+#include <algorithm>
+
+namespace
+{
+    // 작업자 안에서 다시 parallelFor를 부르면 직렬로 실행 (교착 방지)
+    thread_local bool t_insideJob = false;
+}
+
+ThreadPool& ThreadPool::instance()
+{
+    static ThreadPool pool(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+    return pool;
+}
+
+ThreadPool::ThreadPool(int threads)
+    : numThreads(std::max(1, threads))
+{
+    workers.reserve(numThreads - 1);
+    for (int i = 1; i < numThreads; i++)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    startCv.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+int ThreadPool::chunkCount(int count, int minChunk) const
+{
+    if (count <= 0) return 0;
+    int byGrain = std::max(1, count / std::max(1, minChunk));
+    return std::min(numThreads, byGrain);
+}
+
+void ThreadPool::chunkRange(int count, int chunks, int chunk, int& begin, int& end)
+{
+    int base = count / chunks;
+    int extra = count % chunks;
+    begin = chunk * base + std::min(chunk, extra);
+    end = begin + base + (chunk < extra ? 1 : 0);
+}
+
+void ThreadPool::setSerialThread(bool serial)
+{
+    t_insideJob = serial;
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int, int)>& fn, int minChunk)
+{
+    const int chunks = chunkCount(count, minChunk);
+    if (chunks == 0) return;
+    if (chunks == 1 || t_insideJob) {
+        fn(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        jobCount = count;
+        jobChunks = chunks;
+        pending.store(chunks - 1, std::memory_order_relaxed);
+        generation++;
+    }
+    startCv.notify_all();
+
+    int begin, end;
+    chunkRange(count, chunks, 0, begin, end);
+    t_insideJob = true;
+    fn(begin, end);
+    t_insideJob = false;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCv.wait(lock, [&] { return pending.load(std::memory_order_acquire) == 0; });
+    job = nullptr;
+}
+
+void ThreadPool::workerLoop(int id)
+{
+    t_insideJob = true;
+    unsigned long long seen = 0;
+    for (;;)
+    {
+        const std::function<void(int, int)>* fn;
+        int count, chunks;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            startCv.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            fn = job;
+            count = jobCount;
+            chunks = jobChunks;
+        }
+
+        if (id >= chunks) continue; // 이번 작업에는 구간이 없음
+
+        int begin, end;
+        chunkRange(count, chunks, id, begin, end);
+        (*fn)(begin, end);
+
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            doneCv.notify_one();
+        }
+    }
+}
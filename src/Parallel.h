@@ -0,0 +1,59 @@
+﻿#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 고정 작업자 스레드 풀
+// parallelFor는 [0, count)를 연속 구간으로 나누고, 구간 i는 항상 i번 스레드(0 = 호출 스레드)가 실행
+class ThreadPool
+{
+public:
+    static ThreadPool& instance();
+
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 호출 스레드를 포함한 스레드 수
+    int size() const { return numThreads; }
+
+    // fn(begin, end)를 구간별로 실행. 구간 길이가 minChunk보다 작아지지 않도록 구간 수를 줄임
+    void parallelFor(int count, const std::function<void(int, int)>& fn, int minChunk = 1);
+
+    // parallelFor가 count를 나누는 방식 (첫 번째 접근 등 구간을 미리 알아야 할 때)
+    int chunkCount(int count, int minChunk = 1) const;
+    static void chunkRange(int count, int chunks, int chunk, int& begin, int& end);
+
+    // 이 스레드에서 부르는 parallelFor를 모두 직렬로 실행 (fork한 자식처럼 작업자 스레드가 없는 프로세스용)
+    static void setSerialThread(bool serial);
+
+private:
+    void workerLoop(int id);
+
+    int numThreads = 1;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable startCv;
+    std::condition_variable doneCv;
+    unsigned long long generation = 0;
+    bool stopping = false;
+
+    // 현재 작업
+    const std::function<void(int, int)>* job = nullptr;
+    int jobCount = 0;
+    int jobChunks = 0;
+    std::atomic<int> pending{ 0 };
+};
+
+// 기본 풀에서 병렬 실행
+inline void parallelFor(int count, const std::function<void(int, int)>& fn, int minChunk = 1)
+{
+    ThreadPool::instance().parallelFor(count, fn, minChunk);
+}
@@ -0,0 +1,72 @@
+﻿#include "PrecisionBench.h"
+#include "Cloth.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    const float kFarOffset = 1000.0f; // 원점에서 먼 장면 (float 위치 해상도 ~6e-5 m)
+    const float kStep = 1.0f / 60.0f;
+
+    struct BenchResult
+    {
+        bool ok = false;
+        double msPerStep = 0.0;
+        std::vector<glm::dvec3> positions;
+    };
+
+    template<class ClothT>
+    BenchResult runScene(const std::string& objPath, int steps, float offset)
+    {
+        BenchResult r;
+        ClothT cloth(40, 40, 0.05f);
+        if (!objPath.empty() && !cloth.loadFromOBJ(objPath)) return r;
+
+        const int n = static_cast<int>(cloth.getParticles().size());
+        for (int i = 0; i < n; i++)
+            cloth.setParticlePos(i, cloth.getParticlePos(i) + glm::vec3(offset, 0.0f, 0.0f));
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int s = 0; s < steps; s++)
+            cloth.update(kStep);
+        auto t1 = std::chrono::steady_clock::now();
+
+        r.ok = true;
+        r.msPerStep = std::chrono::duration<double, std::milli>(t1 - t0).count() / std::max(1, steps);
+        r.positions.reserve(n);
+        for (const auto& p : cloth.getParticles())
+            r.positions.push_back(glm::dvec3(p.pos));
+        return r;
+    }
+
+    double maxError(const BenchResult& a, const BenchResult& ref)
+    {
+        double e = 0.0;
+        const size_t n = std::min(a.positions.size(), ref.positions.size());
+        for (size_t i = 0; i < n; i++)
+            e = std::max(e, static_cast<double>(glm::length(a.positions[i] - ref.positions[i])));
+        return e;
+    }
+}
+
+int runPrecisionBenchmark(const std::string& objPath, int steps)
+{
+    std::printf("precision benchmark: %s, %d steps\n", objPath.empty() ? "40x40 grid" : objPath.c_str(), steps);
+
+    const float offsets[2] = { 0.0f, kFarOffset };
+    for (float offset : offsets)
+    {
+        BenchResult ref = runScene<ClothDouble>(objPath, steps, offset);
+        BenchResult single = runScene<Cloth>(objPath, steps, offset);
+        BenchResult mixed = runScene<ClothMixed>(objPath, steps, offset);
+        if (!ref.ok || !single.ok || !mixed.ok) return -1;
+
+        std::printf("offset %.0f m\n", offset);
+        std::printf("  float  : %7.3f ms/step  max err %.3e m\n", single.msPerStep, maxError(single, ref));
+        std::printf("  mixed  : %7.3f ms/step  max err %.3e m\n", mixed.msPerStep, maxError(mixed, ref));
+        std::printf("  double : %7.3f ms/step  (reference)\n", ref.msPerStep);
+    }
+    return 0;
+}
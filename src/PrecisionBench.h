@@ -0,0 +1,8 @@
+﻿#pragma once
+
+#include <string>
+
+// 정밀도별 천 벤치마크 (창 없이 실행)
+// 같은 장면을 float / double / 혼합(double 위치 + float 제약)으로 돌려
+// 스텝당 시간과 double 대비 위치 오차를 원점 근처/먼 위치 두 경우로 출력
+int runPrecisionBenchmark(const std::string& objPath, int steps);
@@ -0,0 +1,134 @@
+﻿#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    inline const glm::vec3& strided(const glm::vec3* base, size_t strideBytes, int i)
+    {
+        return *reinterpret_cast<const glm::vec3*>(reinterpret_cast<const char*>(base) + strideBytes * i);
+    }
+}
+
+glm::ivec3 SpatialGrid::cellOf(const glm::vec3& p) const
+{
+    return glm::ivec3(static_cast<int>(std::floor(p.x * invCell)),
+        static_cast<int>(std::floor(p.y * invCell)),
+        static_cast<int>(std::floor(p.z * invCell)));
+}
+
+size_t SpatialGrid::slotOf(int x, int y, int z) const
+{
+    std::uint32_t h = static_cast<std::uint32_t>(x) * 73856093u
+        ^ static_cast<std::uint32_t>(y) * 19349663u
+        ^ static_cast<std::uint32_t>(z) * 83492791u;
+    return h & tableMask;
+}
+
+void SpatialGrid::clear()
+{
+    cellStart.clear();
+    sortedIndex.clear();
+    sortedPos.clear();
+    cellMin = glm::ivec3(0);
+    cellMax = glm::ivec3(-1);
+}
+
+// 카운팅 정렬로 셀별 연속 배치 (O(N))
+void SpatialGrid::build(const glm::vec3* positions, size_t strideBytes, int count, float cell)
+{
+    clear();
+    if (count <= 0 || cell <= 0.0f) return;
+
+    cellSize = cell;
+    invCell = 1.0f / cell;
+
+    size_t tableSize = 1;
+    while (tableSize < static_cast<size_t>(count) * 2) tableSize <<= 1;
+    tableMask = tableSize - 1;
+
+    std::vector<std::uint32_t> slots(count);
+    cellStart.assign(tableSize + 1, 0);
+    cellMin = glm::ivec3(std::numeric_limits<int>::max());
+    cellMax = glm::ivec3(std::numeric_limits<int>::min());
+    for (int i = 0; i < count; i++)
+    {
+        glm::ivec3 c = cellOf(strided(positions, strideBytes, i));
+        cellMin = glm::ivec3(std::min(cellMin.x, c.x), std::min(cellMin.y, c.y), std::min(cellMin.z, c.z));
+        cellMax = glm::ivec3(std::max(cellMax.x, c.x), std::max(cellMax.y, c.y), std::max(cellMax.z, c.z));
+        slots[i] = static_cast<std::uint32_t>(slotOf(c.x, c.y, c.z));
+        cellStart[slots[i] + 1]++;
+    }
+    for (size_t s = 0; s < tableSize; s++)
+        cellStart[s + 1] += cellStart[s];
+
+    sortedIndex.resize(count);
+    sortedPos.resize(count);
+    std::vector<std::uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < count; i++)
+    {
+        std::uint32_t k = cursor[slots[i]]++;
+        sortedIndex[k] = i;
+        sortedPos[k] = strided(positions, strideBytes, i);
+    }
+
+    visitMark.assign(tableSize, 0);
+    visitStamp = 0;
+}
+
+// 반경을 셀 단위로 넓혀가며 탐색, 찾은 거리가 현재 반경 이하면 종료
+int SpatialGrid::nearest(const glm::vec3& p, float maxDist, float* outDist) const
+{
+    if (empty()) return -1;
+
+    // 점에서 전체 바운딩 박스까지 거리만큼은 바로 건너뜀
+    glm::vec3 boxMin = glm::vec3(cellMin) * cellSize;
+    glm::vec3 boxMax = glm::vec3(cellMax + glm::ivec3(1)) * cellSize;
+    glm::vec3 q = glm::clamp(p, boxMin, boxMax);
+    float radius = std::max(cellSize, glm::length(q - p) + cellSize);
+    const float boxDiag = glm::length(boxMax - boxMin);
+
+    int best = -1;
+    float bestD2 = maxDist * maxDist;
+    for (;;)
+    {
+        float r = std::min(radius, maxDist);
+        forEachCell(p - glm::vec3(r), p + glm::vec3(r), [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; k++)
+            {
+                glm::vec3 d = sortedPos[k] - p;
+                float d2 = glm::dot(d, d);
+                if (d2 < bestD2) { bestD2 = d2; best = sortedIndex[k]; }
+            }
+        });
+
+        // 반경 r 안에서 찾았으면 확정 (상자 밖 점은 r보다 멀다)
+        if ((best >= 0 && bestD2 <= r * r) || r >= maxDist || radius > glm::length(q - p) + boxDiag + cellSize)
+            break;
+        radius *= 2.0f;
+    }
+
+    if (outDist && best >= 0) *outDist = std::sqrt(bestD2);
+    return best;
+}
+
+void SpatialGrid::queryRadius(const glm::vec3& p, float radius, std::vector<int>& out) const
+{
+    out.clear();
+    forEachInRadius(p, radius, [&](int i, float) { out.push_back(i); });
+}
+
+void SpatialGrid::queryAABB(const glm::vec3& bmin, const glm::vec3& bmax, std::vector<int>& out) const
+{
+    out.clear();
+    if (empty()) return;
+    forEachCell(bmin, bmax, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++)
+        {
+            const glm::vec3& q = sortedPos[k];
+            if (q.x >= bmin.x && q.y >= bmin.y && q.z >= bmin.z && q.x <= bmax.x && q.y <= bmax.y && q.z <= bmax.z)
+                out.push_back(sortedIndex[k]);
+        }
+    });
+}
@@ -0,0 +1,98 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// 입자 위치용 균일 격자 공간 색인 (해시 셀 + 카운팅 정렬)
+// 셀별로 정렬된 위치 사본을 들고 있어 질의가 연속 메모리만 훑음 (질의는 단일 스레드 전용)
+class SpatialGrid
+{
+public:
+    // positions: strideBytes 간격으로 count개의 glm::vec3 (AoS/SoA 모두 가능)
+    void build(const glm::vec3* positions, size_t strideBytes, int count, float cellSize);
+    void clear();
+
+    bool empty() const { return sortedIndex.empty(); }
+    float getCellSize() const { return cellSize; }
+
+    // 가장 가까운 입자 (maxDist 안에 없으면 -1)
+    int nearest(const glm::vec3& p, float maxDist = 1e30f, float* outDist = nullptr) const;
+
+    // 반경/상자 안의 입자 인덱스
+    void queryRadius(const glm::vec3& p, float radius, std::vector<int>& out) const;
+    void queryAABB(const glm::vec3& bmin, const glm::vec3& bmax, std::vector<int>& out) const;
+
+    // 반경 안의 입자마다 fn(index, distance)
+    template<class Fn>
+    void forEachInRadius(const glm::vec3& p, float radius, Fn&& fn) const
+    {
+        if (empty() || radius <= 0.0f) return;
+        const float r2 = radius * radius;
+        forEachCell(p - glm::vec3(radius), p + glm::vec3(radius), [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; k++)
+            {
+                glm::vec3 d = sortedPos[k] - p;
+                float d2 = glm::dot(d, d);
+                if (d2 < r2) fn(sortedIndex[k], std::sqrt(d2));
+            }
+        });
+    }
+
+private:
+    glm::ivec3 cellOf(const glm::vec3& p) const;
+    size_t slotOf(int x, int y, int z) const;
+
+    // [bmin, bmax]에 걸친 셀마다 fn(begin, end) (같은 슬롯은 한 번만)
+    template<class Fn>
+    void forEachCell(const glm::vec3& bmin, const glm::vec3& bmax, Fn&& fn) const;
+
+    float cellSize = 1.0f;
+    float invCell = 1.0f;
+    size_t tableMask = 0;
+    glm::ivec3 cellMin = glm::ivec3(0);
+    glm::ivec3 cellMax = glm::ivec3(-1);
+
+    std::vector<std::uint32_t> cellStart; // 슬롯별 시작 위치 (tableMask + 2개)
+    std::vector<int> sortedIndex;         // 슬롯 순 입자 인덱스
+    std::vector<glm::vec3> sortedPos;     // 슬롯 순 위치 사본
+    mutable std::vector<std::uint32_t> visitMark;
+    mutable std::uint32_t visitStamp = 0;
+};
+
+template<class Fn>
+void SpatialGrid::forEachCell(const glm::vec3& bmin, const glm::vec3& bmax, Fn&& fn) const
+{
+    glm::ivec3 lo = cellOf(bmin);
+    glm::ivec3 hi = cellOf(bmax);
+    lo = glm::ivec3(std::max(lo.x, cellMin.x), std::max(lo.y, cellMin.y), std::max(lo.z, cellMin.z));
+    hi = glm::ivec3(std::min(hi.x, cellMax.x), std::min(hi.y, cellMax.y), std::min(hi.z, cellMax.z));
+    if (lo.x > hi.x || lo.y > hi.y || lo.z > hi.z) return;
+
+    // 셀 수가 입자 수보다 많으면 슬롯을 그냥 전부 훑는 편이 싸다
+    const double cells = double(hi.x - lo.x + 1) * double(hi.y - lo.y + 1) * double(hi.z - lo.z + 1);
+    if (cells > static_cast<double>(tableMask + 1))
+    {
+        fn(size_t(0), sortedIndex.size());
+        return;
+    }
+
+    // 해시 충돌로 같은 슬롯을 두 번 훑지 않도록 방문 표시
+    if (++visitStamp == 0)
+    {
+        std::fill(visitMark.begin(), visitMark.end(), 0);
+        visitStamp = 1;
+    }
+    for (int z = lo.z; z <= hi.z; z++)
+        for (int y = lo.y; y <= hi.y; y++)
+            for (int x = lo.x; x <= hi.x; x++)
+            {
+                size_t s = slotOf(x, y, z);
+                if (visitMark[s] == visitStamp) continue;
+                visitMark[s] = visitStamp;
+                if (cellStart[s] != cellStart[s + 1]) fn(size_t(cellStart[s]), size_t(cellStart[s + 1]));
+            }
+}
@@ -0,0 +1,222 @@
+﻿#include "TriangleBVH.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const int kLeafSize = 4;
+    const int kRefitGrain = 256;
+
+    inline const glm::vec3& strided(const glm::vec3* base, size_t strideBytes, unsigned int i)
+    {
+        return *reinterpret_cast<const glm::vec3*>(reinterpret_cast<const char*>(base) + strideBytes * i);
+    }
+}
+
+void TriangleBVH::clear()
+{
+    nodes.clear();
+    triOrder.clear();
+    leafNodes.clear();
+    innerByDepth.clear();
+    depthStart.clear();
+    maxDepth = 0;
+}
+
+// 중심점 기준 가장 긴 축의 중앙값 분할 (자식 두 개는 항상 연속 배치)
+void TriangleBVH::build(const glm::vec3* positions, size_t strideBytes, const unsigned int* indices, int triCount)
+{
+    clear();
+    if (triCount <= 0) return;
+
+    std::vector<glm::vec3> centroid(triCount);
+    triOrder.resize(triCount);
+    for (int t = 0; t < triCount; t++)
+    {
+        centroid[t] = (strided(positions, strideBytes, indices[t * 3])
+            + strided(positions, strideBytes, indices[t * 3 + 1])
+            + strided(positions, strideBytes, indices[t * 3 + 2])) * (1.0f / 3.0f);
+        triOrder[t] = t;
+    }
+
+    struct Task { int node, begin, end, depth; };
+    std::vector<Task> stack;
+    std::vector<int> nodeDepth;
+    nodes.reserve(2 * (triCount / kLeafSize + 1));
+
+    nodes.push_back(Node());
+    nodeDepth.push_back(0);
+    stack.push_back({ 0, 0, triCount, 0 });
+
+    while (!stack.empty())
+    {
+        Task task = stack.back();
+        stack.pop_back();
+        maxDepth = std::max(maxDepth, task.depth);
+
+        const int n = task.end - task.begin;
+        if (n <= kLeafSize)
+        {
+            nodes[task.node].first = task.begin;
+            nodes[task.node].count = n;
+            leafNodes.push_back(task.node);
+            continue;
+        }
+
+        glm::vec3 cmin(std::numeric_limits<float>::max());
+        glm::vec3 cmax(-std::numeric_limits<float>::max());
+        for (int i = task.begin; i < task.end; i++)
+        {
+            cmin = glm::min(cmin, centroid[triOrder[i]]);
+            cmax = glm::max(cmax, centroid[triOrder[i]]);
+        }
+        const glm::vec3 ext = cmax - cmin;
+        const int axis = (ext.x >= ext.y && ext.x >= ext.z) ? 0 : (ext.y >= ext.z ? 1 : 2);
+
+        const int mid = task.begin + n / 2;
+        std::nth_element(triOrder.begin() + task.begin, triOrder.begin() + mid, triOrder.begin() + task.end,
+            [&](int a, int b) { return centroid[a][axis] < centroid[b][axis]; });
+
+        const int left = static_cast<int>(nodes.size());
+        nodes[task.node].first = left;
+        nodes[task.node].count = 0;
+        nodes.push_back(Node());
+        nodes.push_back(Node());
+        nodeDepth.push_back(task.depth + 1);
+        nodeDepth.push_back(task.depth + 1);
+        stack.push_back({ left, task.begin, mid, task.depth + 1 });
+        stack.push_back({ left + 1, mid, task.end, task.depth + 1 });
+    }
+
+    // 내부 노드를 깊은 순서로 묶어 둠 (같은 깊이끼리는 서로 독립이라 병렬 refit 가능)
+    depthStart.assign(maxDepth + 2, 0);
+    for (size_t i = 0; i < nodes.size(); i++)
+        if (nodes[i].count == 0) depthStart[maxDepth - nodeDepth[i] + 1]++;
+    for (int d = 0; d <= maxDepth; d++)
+        depthStart[d + 1] += depthStart[d];
+    innerByDepth.resize(depthStart.back());
+    std::vector<int> cursor(depthStart.begin(), depthStart.end() - 1);
+    for (size_t i = 0; i < nodes.size(); i++)
+        if (nodes[i].count == 0) innerByDepth[cursor[maxDepth - nodeDepth[i]]++] = static_cast<int>(i);
+
+    refit(positions, strideBytes, indices);
+}
+
+// 리프 상자를 병렬로 다시 계산한 뒤, 깊은 깊이부터 자식 상자를 합침
+void TriangleBVH::refit(const glm::vec3* positions, size_t strideBytes, const unsigned int* indices)
+{
+    if (nodes.empty()) return;
+
+    parallelFor(static_cast<int>(leafNodes.size()), [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            Node& node = nodes[leafNodes[i]];
+            glm::vec3 bmin(std::numeric_limits<float>::max());
+            glm::vec3 bmax(-std::numeric_limits<float>::max());
+            for (int k = node.first; k < node.first + node.count; k++)
+            {
+                const unsigned int* tri = indices + static_cast<size_t>(triOrder[k]) * 3;
+                for (int v = 0; v < 3; v++)
+                {
+                    const glm::vec3& p = strided(positions, strideBytes, tri[v]);
+                    bmin = glm::min(bmin, p);
+                    bmax = glm::max(bmax, p);
+                }
+            }
+            node.bmin = bmin;
+            node.bmax = bmax;
+        }
+    }, kRefitGrain / kLeafSize);
+
+    for (int d = 0; d <= maxDepth; d++)
+    {
+        const int base = depthStart[d];
+        parallelFor(depthStart[d + 1] - base, [&](int begin, int end) {
+            for (int i = begin; i < end; i++)
+            {
+                Node& node = nodes[innerByDepth[base + i]];
+                const Node& l = nodes[node.first];
+                const Node& r = nodes[node.first + 1];
+                node.bmin = glm::min(l.bmin, r.bmin);
+                node.bmax = glm::max(l.bmax, r.bmax);
+            }
+        }, kRefitGrain);
+    }
+}
+
+// 가까운 자식부터 내려가는 스택 순회 + Moller-Trumbore 교차
+bool TriangleBVH::raycast(const glm::vec3* positions, size_t strideBytes, const unsigned int* indices,
+    const glm::vec3& origin, const glm::vec3& dir, Hit& out, float tMax) const
+{
+    out = Hit();
+    if (nodes.empty()) return false;
+
+    const float inf = std::numeric_limits<float>::infinity();
+    const glm::vec3 invDir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+    float best = tMax;
+
+    // 상자 진입 거리 (안 맞으면 inf)
+    auto slab = [&](const Node& n) -> float {
+        glm::vec3 t0 = (n.bmin - origin) * invDir;
+        glm::vec3 t1 = (n.bmax - origin) * invDir;
+        glm::vec3 tn = glm::min(t0, t1);
+        glm::vec3 tf = glm::max(t0, t1);
+        float enter = std::max(std::max(tn.x, tn.y), std::max(tn.z, 0.0f));
+        float exit = std::min(std::min(tf.x, tf.y), std::min(tf.z, best));
+        return (enter <= exit) ? enter : inf;
+    };
+
+    std::vector<int> stack;
+    stack.reserve(2 * maxDepth + 2);
+    if (slab(nodes[0]) < inf) stack.push_back(0);
+
+    while (!stack.empty())
+    {
+        const Node& n = nodes[stack.back()];
+        stack.pop_back();
+        if (slab(n) == inf) continue; // best가 줄어 더 이상 볼 필요 없음
+
+        if (n.count == 0)
+        {
+            float tl = slab(nodes[n.first]);
+            float tr = slab(nodes[n.first + 1]);
+            int nearChild = n.first, farChild = n.first + 1;
+            if (tr < tl) { std::swap(tl, tr); std::swap(nearChild, farChild); }
+            if (tr < inf) stack.push_back(farChild);
+            if (tl < inf) stack.push_back(nearChild);
+            continue;
+        }
+
+        for (int k = n.first; k < n.first + n.count; k++)
+        {
+            const int tri = triOrder[k];
+            const glm::vec3& a = strided(positions, strideBytes, indices[tri * 3]);
+            const glm::vec3& b = strided(positions, strideBytes, indices[tri * 3 + 1]);
+            const glm::vec3& c = strided(positions, strideBytes, indices[tri * 3 + 2]);
+
+            glm::vec3 e1 = b - a;
+            glm::vec3 e2 = c - a;
+            glm::vec3 pv = glm::cross(dir, e2);
+            float det = glm::dot(e1, pv);
+            if (std::fabs(det) < 1e-12f) continue;
+
+            float invDet = 1.0f / det;
+            glm::vec3 tv = origin - a;
+            float u = glm::dot(tv, pv) * invDet;
+            if (u < 0.0f || u > 1.0f) continue;
+            glm::vec3 qv = glm::cross(tv, e1);
+            float v = glm::dot(dir, qv) * invDet;
+            if (v < 0.0f || u + v > 1.0f) continue;
+            float t = glm::dot(e2, qv) * invDet;
+            if (t < 0.0f || t >= best) continue;
+
+            best = t;
+            out.triangle = tri;
+            out.t = t;
+            out.bary = glm::vec3(1.0f - u - v, u, v);
+        }
+    }
+    return out.triangle >= 0;
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+// 삼각형 BVH (광선 피킹용)
+// 토폴로지가 바뀔 때만 build, 위치만 바뀌면 refit으로 노드 상자만 다시 계산 (깊이별 병렬)
+// positions는 strideBytes 간격의 glm::vec3, indices는 삼각형당 3개 (build/refit/raycast 모두 같은 배열)
+class TriangleBVH
+{
+public:
+    struct Hit
+    {
+        int triangle = -1;      // indices 기준 삼각형 번호
+        float t = 0.0f;         // 광선 매개변수 (dir 길이 단위)
+        glm::vec3 bary{ 0.0f }; // 세 정점에 대한 무게중심 좌표
+    };
+
+    void build(const glm::vec3* positions, size_t strideBytes, const unsigned int* indices, int triCount);
+    void refit(const glm::vec3* positions, size_t strideBytes, const unsigned int* indices);
+    void clear();
+
+    bool empty() const { return nodes.empty(); }
+    int getTriangleCount() const { return static_cast<int>(triOrder.size()); }
+
+    // 가장 가까운 교차 (양면)
+    bool raycast(const glm::vec3* positions, size_t strideBytes, const unsigned int* indices,
+        const glm::vec3& origin, const glm::vec3& dir, Hit& out, float tMax = 1e30f) const;
+
+private:
+    struct Node
+    {
+        glm::vec3 bmin;
+        int first;   // 내부 노드: 왼쪽 자식 (오른쪽은 first + 1), 리프: triOrder 시작
+        glm::vec3 bmax;
+        int count;   // 0이면 내부 노드
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> triOrder;
+    std::vector<int> leafNodes;     // refit 1단계
+    std::vector<int> innerByDepth;  // 깊은 것부터 정렬된 내부 노드
+    std::vector<int> depthStart;    // innerByDepth에서 깊이별 시작 위치
+    int maxDepth = 0;
+};
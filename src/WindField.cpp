@@ -0,0 +1,170 @@
+﻿#include "WindField.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+    const float kTwoPi = 6.28318530718f;
+
+    inline int wrap(int i, int n)
+    {
+        int r = i % n;
+        return (r < 0) ? r + n : r;
+    }
+}
+
+WindField::WindField()
+    : WindField(Params())
+{
+}
+
+WindField::WindField(const Params& p)
+{
+    setParams(p);
+}
+
+WindField::~WindField()
+{
+    if (pending.valid()) pending.wait();
+}
+
+void WindField::setParams(const Params& p)
+{
+    if (pending.valid()) pending.wait();
+    pending = std::future<Frame>();
+
+    params = p;
+    params.resolution = std::max(2, params.resolution);
+    params.tileSize = std::max(1e-3f, params.tileSize);
+    params.keyInterval = std::max(1e-3f, params.keyInterval);
+    buildModes();
+
+    frameA = Frame();
+    frameB = Frame();
+}
+
+// 무작위 모드 구성: 파수가 클수록 진폭을 줄여(|k|^-5/6) 큰 소용돌이가 지배하도록
+void WindField::buildModes()
+{
+    std::mt19937 rng(params.seed);
+    std::uniform_int_distribution<int> kDist(-3, 3);
+    std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+
+    modeList.clear();
+    modeList.reserve(params.modes);
+    while (static_cast<int>(modeList.size()) < params.modes)
+    {
+        glm::vec3 k(kDist(rng), kDist(rng), kDist(rng));
+        float kLen = glm::length(k);
+        if (kLen < 0.5f) continue;
+
+        glm::vec3 d(gauss(rng), gauss(rng), gauss(rng));
+        if (glm::dot(d, d) < 1e-6f) continue;
+        d = glm::normalize(d);
+
+        Mode m;
+        m.k = k;
+        m.curlDir = glm::cross(k * (kTwoPi / params.tileSize), d) * std::pow(kLen, -5.0f / 6.0f);
+        m.omega = (0.5f + uni(rng)) * kLen * params.timeScale;
+        m.phase = uni(rng) * kTwoPi;
+        modeList.push_back(m);
+    }
+}
+
+// 한 키프레임의 속도 격자 생성: u = sum cos(2pi k.x/L + w t + phi) * curlDir, RMS를 amplitude로 맞춤
+WindField::Frame WindField::generate(Params p, std::vector<Mode> modes, float time)
+{
+    const int n = p.resolution;
+    const float cell = p.tileSize / static_cast<float>(n);
+
+    Frame f;
+    f.time = time;
+    f.velocity.assign(static_cast<size_t>(n) * n * n, glm::vec3(0.0f));
+
+    double sumSq = 0.0;
+    for (int z = 0; z < n; z++)
+    {
+        for (int y = 0; y < n; y++)
+        {
+            for (int x = 0; x < n; x++)
+            {
+                glm::vec3 pos(x * cell, y * cell, z * cell);
+                glm::vec3 u(0.0f);
+                for (const Mode& m : modes)
+                {
+                    float theta = kTwoPi * glm::dot(m.k, pos) / p.tileSize + m.omega * time + m.phase;
+                    u += m.curlDir * std::cos(theta);
+                }
+                f.velocity[(static_cast<size_t>(z) * n + y) * n + x] = u;
+                sumSq += glm::dot(u, u);
+            }
+        }
+    }
+
+    const double rms = std::sqrt(sumSq / static_cast<double>(f.velocity.size()));
+    const float scale = (rms > 1e-9) ? static_cast<float>(p.amplitude / rms) : 0.0f;
+    for (auto& u : f.velocity) u *= scale;
+    return f;
+}
+
+void WindField::requestNext(float time)
+{
+    pending = std::async(std::launch::async, &WindField::generate, params, modeList, time);
+}
+
+void WindField::advance(float time)
+{
+    if (!isReady())
+    {
+        // 첫 키프레임만 동기 생성, 다음 것은 바로 비동기로
+        frameA = generate(params, modeList, time);
+        frameB = frameA;
+        requestNext(time + params.keyInterval);
+    }
+
+    // 다음 키프레임이 준비됐고 시간이 지났으면 교체 (준비 전이면 마지막 키프레임 유지)
+    while (time >= frameB.time && pending.valid()
+        && pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        frameA = std::move(frameB);
+        frameB = pending.get();
+        requestNext(frameB.time + params.keyInterval);
+    }
+
+    const float span = frameB.time - frameA.time;
+    blend = (span > 1e-6f) ? std::clamp((time - frameA.time) / span, 0.0f, 1.0f) : 1.0f;
+}
+
+glm::vec3 WindField::sampleFrame(const Frame& f, const glm::vec3& p) const
+{
+    const int n = params.resolution;
+    const glm::vec3 g = p * (static_cast<float>(n) / params.tileSize);
+    const glm::vec3 g0 = glm::floor(g);
+    const glm::vec3 t = g - g0;
+
+    const int x0 = wrap(static_cast<int>(g0.x), n), x1 = wrap(x0 + 1, n);
+    const int y0 = wrap(static_cast<int>(g0.y), n), y1 = wrap(y0 + 1, n);
+    const int z0 = wrap(static_cast<int>(g0.z), n), z1 = wrap(z0 + 1, n);
+
+    auto at = [&](int x, int y, int z) -> const glm::vec3& {
+        return f.velocity[(static_cast<size_t>(z) * n + y) * n + x];
+    };
+
+    glm::vec3 c00 = glm::mix(at(x0, y0, z0), at(x1, y0, z0), t.x);
+    glm::vec3 c10 = glm::mix(at(x0, y1, z0), at(x1, y1, z0), t.x);
+    glm::vec3 c01 = glm::mix(at(x0, y0, z1), at(x1, y0, z1), t.x);
+    glm::vec3 c11 = glm::mix(at(x0, y1, z1), at(x1, y1, z1), t.x);
+    glm::vec3 c0 = glm::mix(c00, c10, t.y);
+    glm::vec3 c1 = glm::mix(c01, c11, t.y);
+    return glm::mix(c0, c1, t.z);
+}
+
+glm::vec3 WindField::sample(const glm::vec3& p) const
+{
+    if (!isReady()) return glm::vec3(0.0f);
+    if (blend <= 0.0f) return sampleFrame(frameA, p);
+    if (blend >= 1.0f) return sampleFrame(frameB, p);
+    return glm::mix(sampleFrame(frameA, p), sampleFrame(frameB, p), blend);
+}
@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include <future>
+#include <vector>
+#include <glm/glm.hpp>
+
+// 타일 반복 3D 난류 바람장
+// 주기적인 푸리에 모드의 curl로 발산 없는 속도 격자를 키프레임마다 미리 구워두고,
+// 다음 키프레임은 작업 스레드에서 비동기로 생성. 샘플링은 삼선형 보간 + 키프레임 간 시간 보간
+class WindField
+{
+public:
+    struct Params
+    {
+        int   resolution = 16;   // 타일 한 변의 셀 수
+        float tileSize = 4.0f;   // 타일 한 변의 길이 (월드 단위, 이 주기로 반복)
+        float amplitude = 2.0f;  // 난류 속도 RMS (m/s)
+        float keyInterval = 0.5f; // 키프레임 간격 (초)
+        float timeScale = 1.0f;  // 모드 위상 변화 속도
+        int   modes = 24;        // 푸리에 모드 수
+        unsigned seed = 1;
+    };
+
+    WindField();
+    explicit WindField(const Params& p);
+    ~WindField();
+
+    WindField(const WindField&) = delete;
+    WindField& operator=(const WindField&) = delete;
+
+    // 파라미터 변경 (키프레임을 처음부터 다시 생성)
+    void setParams(const Params& p);
+    const Params& getParams() const { return params; }
+
+    // 시뮬레이션 시간에 맞춰 키프레임 교체 및 다음 키프레임 생성 요청 (막지 않음)
+    void advance(float time);
+
+    // 현재 시간의 바람 속도 (advance 이후 호출)
+    glm::vec3 sample(const glm::vec3& p) const;
+
+    bool isReady() const { return !frameA.velocity.empty(); }
+
+private:
+    struct Mode
+    {
+        glm::vec3 k;        // 정수 파수 (타일 주기)
+        glm::vec3 curlDir;  // (2pi k / L) x d, 진폭 포함
+        float omega;
+        float phase;
+    };
+
+    struct Frame
+    {
+        float time = 0.0f;
+        std::vector<glm::vec3> velocity;
+    };
+
+    static Frame generate(Params p, std::vector<Mode> modes, float time);
+    void buildModes();
+    void requestNext(float time);
+    glm::vec3 sampleFrame(const Frame& f, const glm::vec3& p) const;
+
+    Params params;
+    std::vector<Mode> modeList;
+    Frame frameA;
+    Frame frameB;
+    std::future<Frame> pending;
+    float blend = 0.0f;
+};
@@ -1,8 +1,48 @@
 ﻿#include "App.h"
+#include "ClothBatch.h"
+#include "ClothStrips.h"
+#include "PrecisionBench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
 
-int main()
+int main(int argc, char** argv)
 {
+    // 정밀도 벤치마크: 창 없이 float/double/혼합을 같은 장면에서 비교 (--bench-precision [obj])
+    if (argc > 1 && std::string(argv[1]) == "--bench-precision")
+        return runPrecisionBenchmark(argc > 2 ? argv[2] : "", 600);
+
+    // SIMD 배치 스윕 벤치마크: 20x20 천 여러 개를 레인 1/8/16으로 비교 (--bench-batch [인스턴스 수])
+    if (argc > 1 && std::string(argv[1]) == "--bench-batch")
+        return runBatchBenchmark(argc > 2 ? std::atoi(argv[2]) : 256, 300);
+
+    // 시작 시간 측정: 큰 격자 천의 토폴로지 생성 시간 (--bench-startup [한 변 파티클 수])
+    if (argc > 1 && std::string(argv[1]) == "--bench-startup")
+    {
+        const int size = argc > 2 ? std::atoi(argv[2]) : 1000;
+        Cloth cloth(size, size, 0.01f);
+        const auto& topo = cloth.getTopologyBuildStats();
+        std::printf("startup %dx%d: %zu particles, %zu springs\n", size, size, cloth.getParticles().size(), cloth.getSprings().size());
+        std::printf("  particles %.2f ms  springs %.2f ms  indices %.2f ms  total %.2f ms\n",
+            topo.particlesMs, topo.springsMs, topo.indicesMs, topo.totalMs());
+        return 0;
+    }
+
+    // 띠 분할 오프라인 실행: 띠마다 프로세스 하나 (--strips <띠 수> <가로> <세로> <프레임> [out.obj])
+    if (argc > 5 && std::string(argv[1]) == "--strips")
+    {
+        StripParams params;
+        params.strips = std::atoi(argv[2]);
+        params.width = std::atoi(argv[3]);
+        params.height = std::atoi(argv[4]);
+        return runStripExport(params, std::atoi(argv[5]), argc > 6 ? argv[6] : "");
+    }
+
     App app(1280, 720);
+
+    // 인자로 OBJ 패널이 주어지면 그리드 대신 메시 천 사용
+    if (argc > 1 && !app.loadClothMesh(argv[1])) return -1;
+
     if (!app.init()) return -1;
     app.run();
     return 0;